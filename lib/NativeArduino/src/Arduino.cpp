@@ -0,0 +1,157 @@
+#include "Arduino.h"
+
+#include <atomic>
+#include <cstdarg>
+
+// ==== Time ====
+
+static uint64_t virtualMicros = 0;
+
+namespace native {
+    void setMicros(uint64_t us) { virtualMicros = us; }
+    void advanceMicros(uint64_t us) { virtualMicros += us; }
+    uint64_t nowMicros() { return virtualMicros; }
+    void setSerialMuted(bool muted) { HardwareSerial::muted = muted; }
+}
+
+unsigned long millis() { return static_cast<unsigned long>(virtualMicros / 1000); }
+unsigned long micros() { return static_cast<unsigned long>(virtualMicros); }
+void delay(unsigned long ms) { virtualMicros += static_cast<uint64_t>(ms) * 1000; }
+void delayMicroseconds(unsigned int us) { virtualMicros += us; }
+
+// ==== Random ====
+
+// xorshift32: cheap, and identical on every host so seeded runs reproduce exactly.
+// Atomic because strips may render on several threads (RenderWorkers); which
+// thread gets which number then depends on scheduling, but no draw is lost.
+static std::atomic<uint32_t> randomState{ 0x2545F491u };
+
+static uint32_t nextRandom() {
+    uint32_t old = randomState.load(std::memory_order_relaxed);
+    uint32_t x;
+    do {
+        x = old;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    } while (!randomState.compare_exchange_weak(old, x, std::memory_order_relaxed));
+    return x;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return static_cast<long>(nextRandom() % static_cast<uint32_t>(howbig));
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+    randomState = seed ? static_cast<uint32_t>(seed) : 0x2545F491u;
+}
+
+uint32_t esp_random() { return nextRandom(); }
+
+// ==== Math ====
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if (run == 0) return -1; // matches the ESP32 core's guard
+    return (x - in_min) * (out_max - out_min) / run + out_min;
+}
+
+char* dtostrf(double number, signed char width, unsigned char prec, char* s) {
+    std::sprintf(s, "%*.*f", width, prec, number);
+    return s;
+}
+
+// ==== String ====
+
+static std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[72];
+    int pos = 0;
+    do {
+        int d = static_cast<int>(value % base);
+        digits[pos++] = static_cast<char>(d < 10 ? '0' + d : 'a' + d - 10);
+        value /= base;
+    } while (value > 0);
+    std::string out = negative ? "-" : "";
+    while (pos > 0) out += digits[--pos];
+    return out;
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return formatInteger(static_cast<unsigned long long>(-(value + 1)) + 1, true, base);
+    }
+    return formatInteger(static_cast<unsigned long long>(value), false, base);
+}
+
+static std::string formatFloat(double value, unsigned char decimalPlaces) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    return buf;
+}
+
+String::String(int value, unsigned char base) : str(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : str(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : str(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : str(formatInteger(value, false, base)) {}
+String::String(float value, unsigned char decimalPlaces) : str(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned char decimalPlaces) : str(formatFloat(value, decimalPlaces)) {}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if (beginIndex >= str.size()) return String();
+    if (endIndex > str.size()) endIndex = static_cast<unsigned int>(str.size());
+    return String(str.substr(beginIndex, endIndex - beginIndex));
+}
+
+int String::indexOf(char c) const {
+    size_t pos = str.find(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::indexOf(const String& s) const {
+    size_t pos = str.find(s.str);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+// ==== Serial ====
+
+HardwareSerial Serial;
+bool HardwareSerial::muted = false;
+
+void HardwareSerial::print(const char* s) {
+    if (!muted && s) std::fputs(s, stderr);
+}
+
+void HardwareSerial::print(char c) {
+    if (!muted) std::fputc(c, stderr);
+}
+
+void HardwareSerial::print(int value) { print(String(value)); }
+void HardwareSerial::print(unsigned int value) { print(String(value)); }
+void HardwareSerial::print(long value) { print(String(value)); }
+void HardwareSerial::print(unsigned long value) { print(String(value)); }
+void HardwareSerial::print(double value, int digits) { print(String(value, static_cast<unsigned char>(digits))); }
+
+int HardwareSerial::printf(const char* format, ...) {
+    if (muted) return 0;
+    va_list args;
+    va_start(args, format);
+    int written = std::vfprintf(stderr, format, args);
+    va_end(args);
+    return written;
+}
+
+// ==== ESP ====
+
+EspClass ESP;
@@ -0,0 +1,81 @@
+#pragma once
+
+// Host-side stand-in for the Arduino core.
+// Only what the render pipeline touches is provided: time, random, math helpers,
+// String and Serial. Time is a virtual clock driven by the simulation so runs are
+// independent of wall-clock speed.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+using std::abs;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+
+#define PI      3.1415926535897932384626433832795
+#define TWO_PI  6.283185307179586476925286766559
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define F(string_literal) (string_literal)
+
+// ==== Time ====
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+
+namespace native {
+    // Virtual clock used by millis()/micros(); the simulation advances it per frame.
+    void setMicros(uint64_t us);
+    void advanceMicros(uint64_t us);
+    uint64_t nowMicros();
+
+    // Silence Serial output (useful for long simulation runs).
+    void setSerialMuted(bool muted);
+}
+
+// ==== Random ====
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+// ==== Math ====
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+char* dtostrf(double number, signed char width, unsigned char prec, char* s);
+
+// ==== GPIO (no-ops on host) ====
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterruptArg(uint8_t, void (*)(void*), void*, int) {}
+inline void detachInterrupt(uint8_t) {}
+
+#include "WString.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Fixed values standing in for the ESP32 system queries used by Debug.
+class EspClass {
+public:
+    uint32_t getFreeHeap() const { return 300000; }
+    uint32_t getMinFreeHeap() const { return 300000; }
+    uint32_t getMaxAllocHeap() const { return 110000; }
+    uint32_t getHeapSize() const { return 327680; }
+    uint32_t getCpuFreqMHz() const { return 240; }
+    uint8_t getChipRevision() const { return 0; }
+    const char* getSdkVersion() const { return "native"; }
+};
+
+extern EspClass ESP;
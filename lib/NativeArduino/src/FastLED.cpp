@@ -0,0 +1,127 @@
+#include "FastLED.h"
+
+#include <atomic>
+
+CFastLED FastLED;
+
+void CFastLED::clear(bool) {
+    for (auto& c : controllers) {
+        fill_solid(c.leds(), c.size(), CRGB::Black);
+    }
+}
+
+// ==== lib8tion ====
+
+static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+uint8_t sin8(uint8_t theta) {
+    uint8_t offset = theta;
+    if (theta & 0x40) offset = 255 - offset;
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) secoffset++;
+
+    uint8_t section = offset >> 4;
+    const uint8_t* p = b_m16_interleave + section * 2;
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+
+    int8_t y = static_cast<int8_t>(mx + b);
+    if (theta & 0x80) y = -y;
+    return static_cast<uint8_t>(y + 128);
+}
+
+// Atomic for the same reason as Arduino.cpp's random() state
+static std::atomic<uint16_t> rand16seed{ 1337 };
+
+uint16_t random16() {
+    uint16_t old = rand16seed.load(std::memory_order_relaxed);
+    uint16_t next;
+    do {
+        next = static_cast<uint16_t>(old * 2053 + 13849);
+    } while (!rand16seed.compare_exchange_weak(old, next, std::memory_order_relaxed));
+    return next;
+}
+
+uint8_t random8() {
+    uint16_t r = random16();
+    return static_cast<uint8_t>(static_cast<uint8_t>(r & 0xFF) + static_cast<uint8_t>(r >> 8));
+}
+
+uint8_t random8(uint8_t lim) {
+    return static_cast<uint8_t>((random8() * lim) >> 8);
+}
+
+uint8_t random8(uint8_t min, uint8_t lim) {
+    return min + random8(lim - min);
+}
+
+void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+uint16_t random16_get_seed() { return rand16seed; }
+
+// ==== Colour conversion (FastLED "rainbow" hue map) ====
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset8 = static_cast<uint8_t>((hue & 0x1F) << 3);
+    uint8_t third = scale8(offset8, 256 / 3);
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) { r = 255 - third; g = third; b = 0; }        // R -> O
+            else { r = 171; g = 85 + third; b = 0; }                          // O -> Y
+        } else {
+            if (!(hue & 0x20)) {                                              // Y -> G
+                uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+                r = 171 - twothirds; g = 170 + third; b = 0;
+            } else { r = 0; g = 255 - third; b = third; }                     // G -> A
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {                                              // A -> B
+                uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+                r = 0; g = 171 - twothirds; b = 85 + twothirds;
+            } else { r = third; g = 0; b = 255 - third; }                     // B -> P
+        } else {
+            if (!(hue & 0x20)) { r = 85 + third; g = 0; b = 171 - third; }    // P -> K
+            else { r = 170 + third; g = 0; b = 85 - third; }                  // K -> R
+        }
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = g = b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            if (r) r = scale8(r, satscale);
+            if (g) g = scale8(g, satscale);
+            if (b) b = scale8(b, satscale);
+            r += desat;
+            g += desat;
+            b += desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = g = b = 0;
+        } else {
+            if (r) r = scale8(r, val);
+            if (g) g = scale8(g, val);
+            if (b) b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+// Host-side subset of FastLED: CRGB/CHSV, the lib8tion helpers the animations use,
+// and a FastLED object that records registered strips instead of driving pins.
+// Colour maths follows FastLED's reference C implementations so frames look the same.
+
+#include <cstdint>
+#include <vector>
+#include "Arduino.h"
+
+// ==== lib8tion ====
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : static_cast<uint8_t>(t);
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : static_cast<uint8_t>(t);
+}
+
+inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return static_cast<uint8_t>((static_cast<uint16_t>(i) * (1 + static_cast<uint16_t>(scale))) >> 8);
+}
+
+inline uint8_t scale8_video(uint8_t i, uint8_t scale) {
+    return static_cast<uint8_t>(((static_cast<int>(i) * static_cast<int>(scale)) >> 8) + ((i && scale) ? 1 : 0));
+}
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, uint8_t frac) {
+    if (b > a) return a + scale8(b - a, frac);
+    return a - scale8(a - b, frac);
+}
+
+uint8_t sin8(uint8_t theta);
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint8_t random8(uint8_t min, uint8_t lim);
+uint16_t random16();
+void random16_set_seed(uint16_t seed);
+uint16_t random16_get_seed();
+
+// ==== Colour types ====
+
+struct CHSV {
+    union {
+        struct {
+            union { uint8_t hue; uint8_t h; };
+            union { uint8_t saturation; uint8_t sat; uint8_t s; };
+            union { uint8_t value; uint8_t val; uint8_t v; };
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : hue(0), sat(0), val(0) {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+        Red = 0xFF0000,
+        Green = 0x008000,
+        Blue = 0x0000FF,
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode) : CRGB(static_cast<uint32_t>(colorcode)) {}
+    CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB& operator=(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB& operator+=(const CRGB& rhs) {
+        r = qadd8(r, rhs.r);
+        g = qadd8(g, rhs.g);
+        b = qadd8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& operator-=(const CRGB& rhs) {
+        r = qsub8(r, rhs.r);
+        g = qsub8(g, rhs.g);
+        b = qsub8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+
+    CRGB& nscale8_video(uint8_t scale) {
+        r = scale8_video(r, scale);
+        g = scale8_video(g, scale);
+        b = scale8_video(b, scale);
+        return *this;
+    }
+
+    CRGB& fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+    CRGB& fadeLightBy(uint8_t fadefactor) { return nscale8_video(255 - fadefactor); }
+
+    CRGB lerp8(const CRGB& other, uint8_t frac) const {
+        return CRGB(lerp8by8(r, other.r, frac), lerp8by8(g, other.g, frac), lerp8by8(b, other.b, frac));
+    }
+
+    bool operator==(const CRGB& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+    bool operator!=(const CRGB& rhs) const { return !(*this == rhs); }
+};
+
+inline CRGB operator+(const CRGB& lhs, const CRGB& rhs) {
+    CRGB out = lhs;
+    out += rhs;
+    return out;
+}
+
+inline CRGB blend(const CRGB& p1, const CRGB& p2, uint8_t amountOfP2) {
+    return p1.lerp8(p2, amountOfP2);
+}
+
+inline void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+    for (int i = 0; i < numToFill; ++i) leds[i] = color;
+}
+
+// ==== Controllers ====
+
+enum EOrder {
+    RGB = 0012,
+    RBG = 0021,
+    GRB = 0102,
+    GBR = 0120,
+    BRG = 0201,
+    BGR = 0210
+};
+
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2811 {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2812 {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2812B {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2813 {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class SK6812 {};
+
+class CLEDController {
+public:
+    CLEDController(CRGB* data, int nLeds, uint8_t pin, EOrder order)
+        : data(data), numLeds(nLeds), pin(pin), order(order) {}
+
+    CRGB* leds() { return data; }
+    int size() const { return numLeds; }
+    uint8_t getPin() const { return pin; }
+    EOrder getOrder() const { return order; }
+
+private:
+    CRGB* data;
+    int numLeds;
+    uint8_t pin;
+    EOrder order;
+};
+
+class CFastLED {
+public:
+    template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController& addLeds(CRGB* data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+        CRGB* start = nLedsIfOffset > 0 ? data + nLedsOrOffset : data;
+        int count = nLedsIfOffset > 0 ? nLedsIfOffset : nLedsOrOffset;
+        controllers.emplace_back(start, count, DATA_PIN, RGB_ORDER);
+        return controllers.back();
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+
+    void show() { ++frames; }
+    void clear(bool writeData = false);
+
+    int count() const { return static_cast<int>(controllers.size()); }
+    CLEDController& operator[](int x) { return controllers[x]; }
+    uint32_t getFrameCount() const { return frames; }
+
+private:
+    std::vector<CLEDController> controllers;
+    uint8_t brightness = 255;
+    uint32_t frames = 0;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+#include "WString.h"
+
+// Serial stand-in that writes to stderr so simulation output on stdout stays clean.
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    void flush() {}
+    explicit operator bool() const { return true; }
+
+    void print(const char* s);
+    void print(const String& s) { print(s.c_str()); }
+    void print(char c);
+    void print(int value);
+    void print(unsigned int value);
+    void print(long value);
+    void print(unsigned long value);
+    void print(double value, int digits = 2);
+
+    template<typename T>
+    void println(const T& value) { print(value); println(); }
+    void println(double value, int digits) { print(value, digits); println(); }
+    void println() { print("\n"); }
+
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    static bool muted;
+};
+
+extern HardwareSerial Serial;
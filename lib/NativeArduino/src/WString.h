@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+// Minimal Arduino String built on std::string.
+class String {
+public:
+    String(const char* s = "") : str(s ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    explicit String(char c) : str(1, c) {}
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(str.size()); }
+    bool isEmpty() const { return str.empty(); }
+
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    int indexOf(char c) const;
+    int indexOf(const String& s) const;
+    long toInt() const { return std::strtol(str.c_str(), nullptr, 10); }
+    float toFloat() const { return std::strtof(str.c_str(), nullptr); }
+    char charAt(unsigned int index) const { return index < str.size() ? str[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String& operator+=(const String& rhs) { str += rhs.str; return *this; }
+    String& operator+=(const char* rhs) { str += rhs ? rhs : ""; return *this; }
+    String& operator+=(char c) { str += c; return *this; }
+
+    bool operator==(const String& rhs) const { return str == rhs.str; }
+    bool operator==(const char* rhs) const { return rhs && str == rhs; }
+    bool operator!=(const String& rhs) const { return !(*this == rhs); }
+    bool operator!=(const char* rhs) const { return !(*this == rhs); }
+    bool operator<(const String& rhs) const { return str < rhs.str; }
+
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs.str + rhs.str); }
+    friend String operator+(const String& lhs, const char* rhs) { return String(lhs.str + (rhs ? rhs : "")); }
+    friend String operator+(const char* lhs, const String& rhs) { return String((lhs ? lhs : "") + rhs.str); }
+
+private:
+    std::string str;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+// Host-side subset of arduinoFFT 2.x: Hamming windowing, radix-2 forward FFT and
+// magnitude conversion, which is all AudioProcessor uses.
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+enum class FFTDirection { Reverse, Forward };
+enum class FFTWindow { Rectangle, Hamming, Hann };
+
+#define FFT_FORWARD         FFTDirection::Forward
+#define FFT_REVERSE         FFTDirection::Reverse
+#define FFT_WIN_TYP_HAMMING FFTWindow::Hamming
+#define FFT_WIN_TYP_HANN    FFTWindow::Hann
+
+template<typename T>
+class ArduinoFFT {
+public:
+    ArduinoFFT(T* vReal, T* vImag, uint_fast16_t samples, T samplingFrequency)
+        : vReal(vReal), vImag(vImag), samples(samples), samplingFrequency(samplingFrequency) {}
+
+    void windowing(FFTWindow windowType, FFTDirection dir) {
+        const T denom = static_cast<T>(samples - 1);
+        for (uint_fast16_t i = 0; i < samples / 2; ++i) {
+            T ratio = static_cast<T>(i) / denom;
+            T factor = 1;
+            switch (windowType) {
+                case FFTWindow::Hamming: factor = 0.54 - 0.46 * std::cos(2.0 * M_PI * ratio); break;
+                case FFTWindow::Hann:    factor = 0.5 * (1.0 - std::cos(2.0 * M_PI * ratio)); break;
+                default: break;
+            }
+            if (dir == FFTDirection::Forward) {
+                vReal[i] *= factor;
+                vReal[samples - 1 - i] *= factor;
+            } else {
+                vReal[i] /= factor;
+                vReal[samples - 1 - i] /= factor;
+            }
+        }
+    }
+
+    void compute(FFTDirection dir) {
+        // Bit-reversal permutation
+        for (uint_fast16_t i = 1, j = 0; i < samples; ++i) {
+            uint_fast16_t bit = samples >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) {
+                std::swap(vReal[i], vReal[j]);
+                std::swap(vImag[i], vImag[j]);
+            }
+        }
+
+        const T sign = dir == FFTDirection::Forward ? -1 : 1;
+        for (uint_fast16_t len = 2; len <= samples; len <<= 1) {
+            T angle = sign * 2.0 * M_PI / static_cast<T>(len);
+            T wRe = std::cos(angle);
+            T wIm = std::sin(angle);
+            for (uint_fast16_t i = 0; i < samples; i += len) {
+                T curRe = 1, curIm = 0;
+                for (uint_fast16_t k = 0; k < len / 2; ++k) {
+                    uint_fast16_t a = i + k;
+                    uint_fast16_t b = a + len / 2;
+                    T tRe = vReal[b] * curRe - vImag[b] * curIm;
+                    T tIm = vReal[b] * curIm + vImag[b] * curRe;
+                    vReal[b] = vReal[a] - tRe;
+                    vImag[b] = vImag[a] - tIm;
+                    vReal[a] += tRe;
+                    vImag[a] += tIm;
+                    T nextRe = curRe * wRe - curIm * wIm;
+                    curIm = curRe * wIm + curIm * wRe;
+                    curRe = nextRe;
+                }
+            }
+        }
+    }
+
+    void complexToMagnitude() {
+        for (uint_fast16_t i = 0; i < samples; ++i) {
+            vReal[i] = std::sqrt(vReal[i] * vReal[i] + vImag[i] * vImag[i]);
+        }
+    }
+
+private:
+    T* vReal;
+    T* vImag;
+    uint_fast16_t samples;
+    T samplingFrequency;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+typedef int esp_err_t;
+
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef void (*shutdown_handler_t)(void);
+
+inline esp_err_t esp_register_shutdown_handler(shutdown_handler_t) { return ESP_OK; }
@@ -14,7 +14,7 @@ private:
     float flashStrength = 0;
 
 public:
-    void update(CRGB* leds, int n, const AudioFeatures& audio) override {
+    void update(CRGB* leds, int n, const AudioFeatures& audio, const FrameContext& frame) override {
         // Basic color hue from spectrum centroid
         float baseHue = fmod(audio.spectrumCentroid * 2.0f, 255.0f);
 
@@ -43,17 +43,18 @@ public:
         if (audio.beatDetected) {
             flashStrength = 255;
         } else {
-            flashStrength *= 0.9f;
+            flashStrength *= frame.decay(0.9f);
         }
 
         if (flashStrength > 5) {
+            int shift = frame.nowMs / 20 % 6;
             for (int i = 0; i < n; i += 6) {
-                leds[(i + (millis() / 20) % 6) % n] += CHSV(baseHue, 255, (uint8_t)flashStrength);
+                leds[(i + shift) % n] += CHSV(baseHue, 255, (uint8_t)flashStrength);
             }
         }
 
         // Slow hue shift
-        hueShift += audio.frequency * 0.001f;
-        wavePhase += audio.volume * 0.1f + 0.01f;
+        hueShift += audio.frequency * 0.001f * frame.steps;
+        wavePhase += (audio.volume * 0.1f + 0.01f) * frame.steps;
     }
 };
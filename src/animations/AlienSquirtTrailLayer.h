@@ -1,62 +1,61 @@
-
 #pragma once
 
 #include <FastLED.h>
 #include <deque>
+#include "../animations/VisualLayer.h"
+#include "../animations/ParticleSystem.h"
 #include "../audio/AudioFeatures.h"
 #include "../audio/AudioSnapshot.h"
 #include "../config/Config.h"
 
-struct SquirtParticle {
-    int position;
-    float velocity;
-    uint8_t hue;
-    float life;
-};
-
-class AlienSquirtTrailLayer {
+// Blue-violet squirts on beats and bass hits, with a faint energy-driven drizzle
+class AlienSquirtTrailLayer : public VisualLayer {
 private:
-    std::vector<SquirtParticle> particles;
-    float spawnCooldown = 0;
+    ParticleSystem particles;
+    ParticleEmitter beatSquirt;
+    ParticleEmitter bassSquirt;
+    ParticleEmitter drizzle;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history) {
-        spawnCooldown -= 1.0f;
-
-        // Trigger new squirt on beat
-        if (now.beatDetected && spawnCooldown <= 0) {
-            SquirtParticle p;
-            p.position = random(NUM_LEDS);
-            p.velocity = random(-3, 4);
-            p.hue = random(160, 200);  // Alien blue-violet
-            p.life = 1.0f;
-            particles.push_back(p);
-            spawnCooldown = 10; // frames between squirts
-        }
-
-        // Update existing particles
-        for (auto& p : particles) {
-            p.position += p.velocity;
-            p.velocity *= 0.9f;
-            p.life -= 0.03f;
-        }
-
-        // Remove dead ones
-        particles.erase(
-            std::remove_if(particles.begin(), particles.end(), [](const SquirtParticle& p) {
-                return p.life <= 0 || p.position < 0 || p.position >= NUM_LEDS;
-            }),
-            particles.end()
-        );
+    AlienSquirtTrailLayer() {
+        beatSquirt.trigger = ParticleEmitter::Trigger::BEAT;
+        beatSquirt.burst = 10;
+        beatSquirt.speed = 3.0f;
+        beatSquirt.hueMin = 160;  // Alien blue-violet
+        beatSquirt.hueMax = 200;
+        beatSquirt.fade = 8;
+
+        bassSquirt.trigger = ParticleEmitter::Trigger::BASS_HIT;
+        bassSquirt.origin = ParticleEmitter::Origin::DOMINANT;
+        bassSquirt.burst = 6;
+        bassSquirt.speed = 2.0f;
+        bassSquirt.hueMin = 180;
+        bassSquirt.hueMax = 215;
+        bassSquirt.fade = 10;
+
+        drizzle.trigger = ParticleEmitter::Trigger::ENERGY;
+        drizzle.rate = 0.5f;
+        drizzle.speed = 0.4f;
+        drizzle.hueMin = 150;
+        drizzle.hueMax = 190;
+        drizzle.fade = 4;
     }
 
-    void render(CRGB* leds, int count) {
-        for (const auto& p : particles) {
-            if (p.position >= 0 && p.position < count) {
-                uint8_t brightness = p.life * 255;
-                leds[p.position] += CHSV(p.hue, 255, brightness);
-            }
-        }
+    void attach(int ledCount, ScratchAllocator& scratch) override {
+        int capacity = constrain((int)(ledCount * PARTICLES_PER_LED), 16, PARTICLE_MAX_PER_SYSTEM);
+        particles.attach(ledCount, capacity, scratch);
     }
-};
 
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history, const FrameContext&) override {
+        particles.step(0.92f);
+        beatSquirt.update(now, particles);
+        bassSquirt.update(now, particles);
+        drizzle.update(now, particles);
+    }
+
+    void render(CRGB* leds, int count) override {
+        particles.render(leds, count);
+    }
+
+    const char* getName() const override { return "AlienSquirtTrailLayer"; }
+};
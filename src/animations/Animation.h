@@ -2,10 +2,20 @@
 #pragma once
 #include <FastLED.h>
 #include "../audio/AudioFeatures.h"
+#include "../core/LedArena.h"
+#include "../core/FrameContext.h"
 
 class Animation {
 public:
     virtual ~Animation() = default;
     virtual void begin() {}
-    virtual void update(CRGB* leds, int n, const AudioFeatures& features) = 0;
+    // Called once the animation is bound to a strip; take working buffers from scratch
+    virtual void attach(int ledCount, ScratchAllocator& scratch) {}
+    virtual void update(CRGB* leds, int n, const AudioFeatures& features, const FrameContext& frame) = 0;
+
+    // Level of detail, as for VisualLayer: animations that overwrite the whole
+    // strip each frame with smooth content can return a shift up to
+    // LOD_MAX_SHIFT and write sample k (strip pixel k * step) in updateSampled()
+    virtual uint8_t maxLodShift() const { return 0; }
+    virtual void updateSampled(CRGB* out, int samples, int n, int step, const AudioFeatures& features, const FrameContext& frame) {}
 };
\ No newline at end of file
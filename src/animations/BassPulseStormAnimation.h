@@ -8,11 +8,13 @@ public:
     static constexpr float preferredTempo = 1.0f;
     static constexpr float intensity = 1.0f;
 
-    void update(CRGB* leds, int count, const AudioFeatures& f) override {
-        static uint8_t hue = 0;
+    void update(CRGB* leds, int count, const AudioFeatures& f, const FrameContext&) override {
         if (f.beatDetected || f.bassHits > 0) hue += 32;
 
         uint8_t brightness = constrain(f.bass * 255 + f.peak * 128, 50, 255);
         fill_solid(leds, count, CHSV(hue, 255, brightness));
     }
+
+private:
+    uint8_t hue = 0;   // Per instance, so strips and scene slots don't step each other's hue
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <new>
+#include "../animations/VisualLayer.h"
+#include "../scenes/LayerTypes.h"
+#include "../animations/VisualLayers.h"
+#include "../animations/AlienSquirtTrailLayer.h"
+
+struct LayerMeta {
+    const char* name;
+    LayerType type;               // Slot it fills when spawned by type
+    uint16_t cost;                // Render cost per pixel, ns on the host bench (env:native-bench)
+    uint32_t lifetimeMs;          // Default lifetime when spawned by type; 0 lasts the scene
+    std::function<VisualLayer*()> create;
+    size_t size;                  // sizeof/alignof the class, for LayerPool's preallocated slots
+    size_t align;
+    VisualLayer* (*construct)(void* at);
+};
+
+template<typename T>
+LayerMeta layerEntry(const char* name, LayerType type, uint16_t cost, uint32_t lifetimeMs) {
+    return { name, type, cost, lifetimeMs, []() -> VisualLayer* { return new T(); },
+             sizeof(T), alignof(T), [](void* at) -> VisualLayer* { return new (at) T(); } };
+}
+
+// Central registry of visual layers, mirroring animationCatalog.
+// Costs are rounded from native-bench runs at 300 LEDs; only their ratios matter.
+inline const std::array<LayerMeta, 22> layerCatalog = {{
+    layerEntry<EnergyPulseRiverLayer>("EnergyPulseRiver", LayerType::ENERGY, 30, 6000),
+    layerEntry<DominantBandFireTrailLayer>("DominantBandFireTrail", LayerType::OVERLAY, 4, 8000),
+    layerEntry<NoiseFloorMistLayer>("NoiseFloorMist", LayerType::BACKGROUND, 12, 0),
+    layerEntry<DynamicsFlickerStormLayer>("DynamicsFlickerStorm", LayerType::ENERGY, 17, 6000),
+    layerEntry<TriwaveBeatLayer>("TriwaveBeat", LayerType::REACTIVE, 20, 3000),
+    layerEntry<EnergySpiralLayer>("EnergySpiral", LayerType::ENERGY, 40, 6000),
+    layerEntry<DominantBandTrailLayer>("DominantBandTrail", LayerType::OVERLAY, 8, 8000),
+    layerEntry<WaveformScribbleLayer>("WaveformScribble", LayerType::OVERLAY, 2, 8000),
+    layerEntry<CentroidRadianceLayer>("CentroidRadiance", LayerType::BACKGROUND, 30, 0),
+    layerEntry<BassShockwaveLayer>("BassShockwave", LayerType::REACTIVE, 4, 3000),
+    layerEntry<WormholeVortexLayer>("WormholeVortex", LayerType::BACKGROUND, 25, 0),
+    layerEntry<EnergyFogLayer>("EnergyFog", LayerType::BACKGROUND, 12, 0),
+    layerEntry<LoudnessLightningLayer>("LoudnessLightning", LayerType::HIGHLIGHT, 2, 2000),
+    layerEntry<MoodMemoryArcLayer>("MoodMemoryArc", LayerType::MOOD_ARC, 8, 15000),
+    layerEntry<TrebleSparkleLayer>("TrebleSparkle", LayerType::HIGHLIGHT, 2, 2000),
+    layerEntry<CentroidGlowWipeLayer>("CentroidGlowWipe", LayerType::OVERLAY, 3, 8000),
+    layerEntry<SpectralRibbonLayer>("SpectralRibbon", LayerType::OVERLAY, 4, 8000),
+    layerEntry<BPMWavePulseLayer>("BPMWavePulse", LayerType::REACTIVE, 1, 3000),
+    layerEntry<BeatFlashSparkLayer>("BeatFlashSpark", LayerType::HIGHLIGHT, 2, 2000),
+    layerEntry<BPMBeatFlashLayer>("BPMBeatFlash", LayerType::REACTIVE, 2, 3000),
+    layerEntry<CentroidColorFlowLayer>("CentroidColorFlow", LayerType::MOOD_ARC, 17, 15000),
+    layerEntry<AlienSquirtTrailLayer>("AlienSquirtTrail", LayerType::REACTIVE, 1, 4000),
+}};
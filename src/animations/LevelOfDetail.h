@@ -0,0 +1,54 @@
+#pragma once
+
+#include <FastLED.h>
+#include "../config/Config.h"
+
+// Reduced-resolution rendering for content with no fine spatial detail.
+//
+// At LOD shift s a layer or animation evaluates one sample every 2^s pixels:
+// sample k stands for strip pixel k << s. The caller then interpolates the
+// samples linearly back up to full length. One extra sample past the end
+// covers the pixels after the last whole step, so the evaluated positions may
+// run slightly past count - 1.
+
+// Samples needed to cover count pixels at a shift
+inline int lodSamples(int count, uint8_t shift) {
+    return count <= 0 ? 0 : ((count - 1) >> shift) + 2;
+}
+
+// Coarsest shift up to maxShift that still leaves LOD_MIN_SAMPLES samples on
+// the strip; short strips stay at full resolution
+inline uint8_t lodShiftFor(uint8_t maxShift, int count) {
+    uint8_t shift = 0;
+    while (shift < maxShift && (count >> (shift + 1)) >= LOD_MIN_SAMPLES) shift++;
+    return shift;
+}
+
+// Linear interpolation of samples at `shift` onto count pixels; op(dst[i], colour)
+// decides how each interpolated colour lands (copy, add, ...)
+template<typename Op>
+inline void lodUpsample(const CRGB* samples, uint8_t shift, CRGB* dst, int count, Op op) {
+    const int step = 1 << shift;
+    for (int base = 0, k = 0; base < count; base += step, ++k) {
+        const CRGB& a = samples[k];
+        const CRGB& b = samples[k + 1];
+        int end = base + step < count ? base + step : count;
+        // Channels scaled by step, stepped by the difference each pixel
+        int r = a.r << shift, g = a.g << shift, bl = a.b << shift;
+        const int dr = b.r - a.r, dg = b.g - a.g, db = b.b - a.b;
+        for (int i = base; i < end; ++i) {
+            op(dst[i], CRGB(r >> shift, g >> shift, bl >> shift));
+            r += dr;
+            g += dg;
+            bl += db;
+        }
+    }
+}
+
+inline void lodUpsampleCopy(const CRGB* samples, uint8_t shift, CRGB* dst, int count) {
+    lodUpsample(samples, shift, dst, count, [](CRGB& d, const CRGB& c) { d = c; });
+}
+
+inline void lodUpsampleAdd(const CRGB* samples, uint8_t shift, CRGB* dst, int count) {
+    lodUpsample(samples, shift, dst, count, [](CRGB& d, const CRGB& c) { d += c; });
+}
@@ -7,7 +7,6 @@
 
 class MoodReactiveAnimation : public Animation {
 private:
-    unsigned long lastUpdate = 0;
     MoodHistory& moodHistory;
     CRGBPalette16 palette;
 
@@ -25,8 +24,8 @@ public:
         palette = RainbowColors_p;
     }
 
-    void update(CRGB* leds, int numLeds, const AudioFeatures& audio) override {
-        unsigned long now = millis();
+    void update(CRGB* leds, int numLeds, const AudioFeatures& audio, const FrameContext& frame) override {
+        unsigned long now = frame.nowMs;
         MoodSnapshot mood = moodHistory.latest();
         MoodType currentMood = detectMood(mood);
 
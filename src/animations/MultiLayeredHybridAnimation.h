@@ -15,6 +15,8 @@ private:
     float opacities[3];
     unsigned long lastSwitch = 0;
     size_t currentIndex = 0;
+    CRGB* temp = nullptr;
+    int tempSize = 0;
 
 public:
     MultiLayeredHybridAnimation() {
@@ -29,16 +31,22 @@ public:
         for (int i = 0; i < 3; ++i) delete layers[i];
     }
 
+    void attach(int ledCount, ScratchAllocator& scratch) override {
+        temp = scratch.allocate<CRGB>(ledCount);
+        tempSize = temp ? ledCount : 0;
+        for (int i = 0; i < 3; ++i) layers[i]->attach(ledCount, scratch);
+    }
+
     // Add this override to satisfy the base class
-    void update(CRGB* leds, int n, const AudioFeatures& now) override {
+    void update(CRGB* leds, int n, const AudioFeatures& now, const FrameContext& frame) override {
         static std::deque<AudioSnapshot> dummyHistory;
-        update(leds, n, now, dummyHistory);
+        update(leds, n, now, dummyHistory, frame);
     }
 
-    void update(CRGB* leds, int n, const AudioFeatures& now, const std::deque<AudioSnapshot>& history) {
+    void update(CRGB* leds, int n, const AudioFeatures& now, const std::deque<AudioSnapshot>& history, const FrameContext& frame) {
         fill_solid(leds, n, CRGB::Black);
 
-        unsigned long nowTime = millis();
+        unsigned long nowTime = frame.nowMs;
         if (nowTime - lastSwitch > 10000) {
             currentIndex = (currentIndex + 1) % 3;
             for (int i = 0; i < 3; ++i) opacities[i] = 0.3;
@@ -46,10 +54,15 @@ public:
             lastSwitch = nowTime;
         }
 
+        // Without a scratch buffer only the foreground animation can be drawn
+        if (n > tempSize) {
+            layers[currentIndex]->update(leds, n, now, frame);
+            return;
+        }
+
         for (int i = 0; i < 3; ++i) {
-            CRGB temp[n];
             fill_solid(temp, n, CRGB::Black);
-            layers[i]->update(temp, n, now);
+            layers[i]->update(temp, n, now, frame);
             for (int j = 0; j < n; ++j) {
                 leds[j].r = qadd8(leds[j].r, temp[j].r * opacities[i]);
                 leds[j].g = qadd8(leds[j].g, temp[j].g * opacities[i]);
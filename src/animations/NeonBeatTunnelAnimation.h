@@ -8,9 +8,10 @@ public:
     static constexpr float preferredTempo = 1.2f;
     static constexpr float intensity = 0.9f;
 
-    void update(CRGB* leds, int count, const AudioFeatures& f) override {
+    void update(CRGB* leds, int count, const AudioFeatures& f, const FrameContext& frame) override {
+        uint8_t scroll = frame.ramp8(4);
         for (int i = 0; i < count; ++i) {
-            uint8_t wave = sin8(i * 8 + millis() / 4);
+            uint8_t wave = sin8(i * 8 + scroll);
             leds[i] = CHSV((i * 2 + wave) % 255, 255, wave * f.volume);
         }
     }
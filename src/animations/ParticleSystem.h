@@ -0,0 +1,203 @@
+#pragma once
+
+#include <FastLED.h>
+#include <math.h>
+#include "../audio/AudioFeatures.h"
+#include "../config/Config.h"
+#include "../core/LedArena.h"
+
+// Fixed-capacity 1D particle engine for layers and animations.
+//
+// Storage is structure-of-arrays taken once from the strip's scratch region:
+// the step loop streams through position/velocity/life and the render loop
+// through position/life/hue, with no per-particle heap objects. Dead particles
+// are swap-removed, so the live ones stay packed at the front and spawning is
+// an append. Positions are float pixels and are splatted across the two
+// nearest LEDs, so slow particles glide instead of jumping a pixel at a time.
+class ParticleSystem {
+public:
+    // Bytes of scratch per particle
+    static constexpr size_t bytesPerParticle = 2 * sizeof(float) + 3;
+
+    bool attach(int ledCount, int maxParticles, ScratchAllocator& scratch) {
+        length = ledCount;
+        count = 0;
+        capacity = 0;
+        position = scratch.allocate<float>(maxParticles);
+        velocity = scratch.allocate<float>(maxParticles);
+        life = scratch.allocate<uint8_t>(maxParticles);
+        fade = scratch.allocate<uint8_t>(maxParticles);
+        hue = scratch.allocate<uint8_t>(maxParticles);
+        if (!position || !velocity || !life || !fade || !hue) return false;
+        capacity = maxParticles;
+        return true;
+    }
+
+    // Spawn one particle; full systems drop it and count the drop
+    bool emit(float pos, float vel, uint8_t h, uint8_t fadePerStep) {
+        if (count >= capacity) {
+            dropped++;
+            return false;
+        }
+        position[count] = pos;
+        velocity[count] = vel;
+        life[count] = 255;
+        fade[count] = fadePerStep > 0 ? fadePerStep : 1;
+        hue[count] = h;
+        count++;
+        return true;
+    }
+
+    // Advance every particle one frame; drag is the per-frame velocity multiplier
+    void step(float drag) {
+        const float maxPos = (float)(length - 1);
+        int i = 0;
+        while (i < count) {
+            float p = position[i] + velocity[i];
+            if (life[i] <= fade[i] || p < 0.0f || p > maxPos) {
+                swapRemove(i);
+                continue;
+            }
+            position[i] = p;
+            velocity[i] *= drag;
+            life[i] -= fade[i];
+            ++i;
+        }
+    }
+
+    // Additive render; brightness follows remaining life
+    void render(CRGB* leds, int ledCount) const {
+        const CRGB* palette = huePalette();
+        for (int i = 0; i < count; ++i) {
+            float p = position[i];
+            int left = (int)p;
+            uint8_t frac = (uint8_t)((p - left) * 255.0f);
+            CRGB c = palette[hue[i]];
+            c.nscale8(life[i]);
+            if (left >= 0 && left < ledCount) {
+                CRGB part = c;
+                leds[left] += part.nscale8(255 - frac);
+            }
+            if (left + 1 >= 0 && left + 1 < ledCount && frac) {
+                CRGB part = c;
+                leds[left + 1] += part.nscale8(frac);
+            }
+        }
+    }
+
+    void clear() { count = 0; }
+    int size() const { return count; }
+    int getCapacity() const { return capacity; }
+    int getLength() const { return length; }
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    void swapRemove(int i) {
+        int last = --count;
+        position[i] = position[last];
+        velocity[i] = velocity[last];
+        life[i] = life[last];
+        fade[i] = fade[last];
+        hue[i] = hue[last];
+    }
+
+    // Full-saturation rainbow, built once and shared by every system. A local
+    // static's initialisation is thread-safe, so two render lanes can't race it.
+    static const CRGB* huePalette() {
+        struct Table {
+            CRGB colors[256];
+            Table() { for (int h = 0; h < 256; ++h) colors[h] = CHSV((uint8_t)h, 255, 255); }
+        };
+        static const Table table;
+        return table.colors;
+    }
+
+    float* position = nullptr;
+    float* velocity = nullptr;
+    uint8_t* life = nullptr;
+    uint8_t* fade = nullptr;
+    uint8_t* hue = nullptr;
+    int count = 0;
+    int capacity = 0;
+    int length = 0;
+    uint32_t dropped = 0;
+};
+
+// Spawns particles from audio events. One emitter per trigger; a layer usually
+// combines a burst trigger with a continuous one.
+struct ParticleEmitter {
+    enum class Trigger : uint8_t {
+        BEAT,        // burst on beatDetected
+        BASS_HIT,    // burst whenever bassHits increases
+        PEAK,        // burst when peak crosses threshold
+        ENERGY       // continuous: up to rate particles per frame, scaled by energy
+    };
+
+    enum class Origin : uint8_t {
+        RANDOM,      // anywhere on the strip
+        CENTER,
+        DOMINANT     // position follows the dominant FFT band
+    };
+
+    Trigger trigger = Trigger::BEAT;
+    Origin origin = Origin::RANDOM;
+    uint8_t burst = 8;             // particles per burst
+    float rate = 0.0f;             // ENERGY: particles per frame at full-scale energy
+    float energyScale = 1800.0f;   // ENERGY: spectral energy treated as full scale
+    float threshold = 0.6f;        // PEAK
+    float speed = 1.5f;            // max |velocity|, pixels per frame
+    uint8_t hueMin = 0;
+    uint8_t hueMax = 255;
+    uint8_t fade = 6;              // life lost per step; 255/fade is the lifetime in frames
+
+    // Runs once per update; returns the particles spawned
+    int update(const AudioFeatures& audio, ParticleSystem& system) {
+        int spawn = 0;
+        switch (trigger) {
+            case Trigger::BEAT:
+                if (audio.beatDetected) spawn = burst;
+                break;
+            case Trigger::BASS_HIT:
+                // A new emitter takes the current count, so it doesn't burst for hits before it existed
+                if (bassHitsSeen && audio.bassHits != lastBassHits) spawn = burst;
+                lastBassHits = audio.bassHits;
+                bassHitsSeen = true;
+                break;
+            case Trigger::PEAK:
+                if (audio.peak > threshold && !aboveThreshold) spawn = burst;
+                aboveThreshold = audio.peak > threshold;
+                break;
+            case Trigger::ENERGY: {
+                credit += rate * constrain(audio.energy / energyScale, 0.0f, 1.0f);
+                spawn = (int)credit;
+                credit -= spawn;
+                break;
+            }
+        }
+        if (spawn == 0 || system.getLength() <= 0) return 0;
+
+        const int length = system.getLength();
+        float center;
+        switch (origin) {
+            case Origin::CENTER: center = length * 0.5f; break;
+            case Origin::DOMINANT: center = (float)audio.dominantBand * length / (NUM_SAMPLES / 2); break;
+            case Origin::RANDOM:
+            default: center = (float)random(length); break;
+        }
+
+        int emitted = 0;
+        for (int i = 0; i < spawn; ++i) {
+            float velocity = speed * ((int)random(-100, 101) / 100.0f);
+            uint8_t h = hueMin + (hueMax > hueMin ? random(hueMax - hueMin + 1) : 0);
+            if (!system.emit(constrain(center, 0.0f, (float)(length - 1)), velocity, h, fade)) break;
+            emitted++;
+        }
+        return emitted;
+    }
+
+private:
+    int lastBassHits = 0;
+    bool bassHitsSeen = false;
+    bool aboveThreshold = false;
+    float credit = 0.0f;
+};
@@ -7,27 +7,23 @@
 
 class PsychedelicInkSquirtAnimation : public Animation {
 private:
-    uint8_t hueBase = 0;
+    float hueDrift = 0;
     float offset = 0;
     float velocity = 0.2f;
-    unsigned long lastUpdate = 0;
 
 public:
     void begin() override {
-        hueBase = 0;
+        hueDrift = 0;
         offset = 0;
-        lastUpdate = millis();
     }
 
-    void update(CRGB* leds, int n, const AudioFeatures& audio) override {
-        unsigned long now = millis();
-        float deltaTime = (now - lastUpdate) / 1000.0f;
-        lastUpdate = now;
+    void update(CRGB* leds, int n, const AudioFeatures& audio, const FrameContext& frame) override {
+        // Drifts a hue step per reference frame and jumps ahead on a beat
+        hueDrift = fmodf(hueDrift + frame.steps + (audio.beatDetected ? 9 : 0), 256.0f);
+        uint8_t hueBase = (uint8_t)hueDrift;
+        offset += frame.dt * (0.1f + audio.bass * 2.0f + audio.energy * 0.05f);
 
-        hueBase += (audio.beatDetected ? 10 : 1);
-        offset += deltaTime * (0.1f + audio.bass * 2.0f + audio.energy * 0.05f);
-
-        float squidWave = sin8(millis() / 8) / 255.0f;
+        float squidWave = sin8(frame.ramp8(8)) / 255.0f;
         float blobIntensity = audio.volume + (audio.dynamics * 0.5f);
 
         for (int i = 0; i < n; ++i) {
@@ -8,12 +8,20 @@ public:
     static constexpr float preferredTempo = 0.5f;  // Slower
     static constexpr float intensity = 0.8f;
 
-    void update(CRGB* leds, int count, const AudioFeatures& f) override {
+    // Sine with a ~31-pixel period
+    uint8_t maxLodShift() const override { return 1; }
+
+    void updateSampled(CRGB* out, int samples, int count, int step, const AudioFeatures& f, const FrameContext& frame) override {
         float waveSpeed = f.spectrumCentroid * 0.2f + f.bass * 0.8f;
-        uint8_t baseHue = millis() / 10;
-        for (int i = 0; i < count; i++) {
-            float pos = sinf(i * 0.2f + millis() * 0.001f * waveSpeed);
-            leds[i] = CHSV(baseHue + pos * 50, 255, 100 + 100 * pos);
+        uint8_t baseHue = frame.ramp8(10);
+        float shift = frame.time * waveSpeed;
+        for (int k = 0; k < samples; k++) {
+            float pos = sinf(k * step * 0.2f + shift);
+            out[k] = CHSV(baseHue + pos * 50, 255, 100 + 100 * pos);
         }
     }
+
+    void update(CRGB* leds, int count, const AudioFeatures& f, const FrameContext& frame) override {
+        updateSampled(leds, count, count, 1, f, frame);
+    }
 };
@@ -4,13 +4,36 @@
 #include <deque>
 #include "../audio/AudioFeatures.h"
 #include "../audio/AudioSnapshot.h"
+#include "../audio/AudioEvents.h"
+#include "../core/LedArena.h"
+#include "../core/FrameContext.h"
+
+// Half-open pixel range [begin, end)
+struct PixelSpan {
+    int begin = 0;
+    int end = 0;
+
+    int length() const { return end > begin ? end - begin : 0; }
+    bool empty() const { return end <= begin; }
+
+    // Clipped to [0, count)
+    static PixelSpan of(int begin, int end, int count) {
+        PixelSpan span;
+        span.begin = begin < 0 ? 0 : begin;
+        span.end = end > count ? count : end;
+        if (span.end < span.begin) span.end = span.begin;
+        return span;
+    }
+};
 
 class VisualLayer {
 public:
+    static constexpr int maxSpans = 2;
+
     virtual ~VisualLayer() = default;
 
     float opacity = 1.0f;
-    String name = "Unnamed";
+    const char* name = "Unnamed";  // A literal; layers must not allocate when spawned
 
     // Optional: How long should this layer remain active (ms)
     unsigned long lifetimeMs = 0;
@@ -19,9 +42,70 @@ public:
     // Optional category tagging
     bool persistent = false;
 
-    virtual void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history) = 0;
+    // Called when the layer is attached to a strip; take per-instance buffers from scratch
+    virtual void attach(int ledCount, ScratchAllocator& scratch) {}
+
+    // Called once per layer step. LayerManager steps layers at the reference
+    // frame rate (LED_FRAME_INTERVAL_US) times their speed, whatever the real
+    // frame rate, so per-step motion needs no dt. Time-derived values go into
+    // members here, so render() reads no clock.
+    virtual void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history, const FrameContext& frame) = 0;
     virtual void render(CRGB* leds, int count) = 0;
 
+    // Event-driven layers return the events they react to from wakeEvents()
+    // and get each one in onEvent() when it is published, ahead of the next
+    // update(), instead of polling AudioFeatures flags. While dormant() is
+    // true a layer has nothing to draw and nothing to advance, and
+    // LayerManager skips both its update() and render() until an event wakes it.
+    virtual EventMask wakeEvents() const { return 0; }
+    virtual void onEvent(const AudioEvent& event) {}
+    virtual bool dormant() const { return false; }
+
+    // Fused evaluation. Layers whose pixels depend only on per-frame state
+    // return true from fusable() and implement renderChunk(), which adds pixels
+    // [begin, begin + length) of a count-pixel strip into out[0, length) and
+    // must not depend on how the strip is split. LayerManager then draws runs
+    // of such layers one LAYER_CHUNK_PIXELS chunk at a time, so each chunk is
+    // touched by every layer while it is still in cache.
+    virtual bool fusable() const { return false; }
+    virtual void renderChunk(CRGB* out, int begin, int length, int count) {}
+
+    // Output caching. A layer whose render() depends on only a few inputs returns
+    // a key that changes whenever its output would; while it stays the same,
+    // LayerManager re-blends the last output instead of calling render(). 0
+    // (the default) opts out. Call between update() and render().
+    virtual uint32_t renderKey() const { return 0; }
+
+    // Cached layers that add one colour to every pixel report it here, so the
+    // cache is that colour rather than a frame buffer
+    virtual bool uniformColor(CRGB& color) const { return false; }
+
+    // Level of detail, as a power-of-two step: layers with no fine spatial
+    // detail return up to LOD_MAX_SHIFT and implement renderSampled(), and
+    // LayerManager may render them at one sample per 2^shift pixels and
+    // interpolate up (see LevelOfDetail.h). Such layers cover the whole strip.
+    virtual uint8_t maxLodShift() const { return 0; }
+
+    // Add sample k, which stands for strip pixel k * step, into out[k]
+    virtual void renderSampled(CRGB* out, int samples, int count, int step) {}
+
+    // The pixels render() will touch this frame, as up to maxSpans sorted,
+    // non-overlapping spans, valid between update() and render(). Returns how
+    // many were written; 0 means render() would draw nothing and is skipped.
+    // LayerManager only clears and blends these pixels.
+    virtual int spans(int count, PixelSpan* out) const {
+        out[0] = PixelSpan::of(0, count, count);
+        return 1;
+    }
+    virtual const char* getName() const { return name; }
+
+    // render() for fusable layers: renderChunk() over each reported span
+    void renderSpans(CRGB* leds, int count) {
+        PixelSpan span[maxSpans];
+        int n = spans(count, span);
+        for (int s = 0; s < n; ++s) renderChunk(leds + span[s].begin, span[s].begin, span[s].length(), count);
+    }
+
     bool isExpired(unsigned long now) const {
         return lifetimeMs > 0 && now - activationTime >= lifetimeMs;
     }
@@ -8,6 +8,7 @@
 #include "../audio/AudioFeatures.h"
 #include "../config/Config.h"
 #include "../audio/AudioSnapshot.h"
+#include "../utils/SparseSampler.h"
 
 
 // === Layer 4: Energy Pulse River ===
@@ -17,20 +18,26 @@ class EnergyPulseRiverLayer : public VisualLayer {
     uint8_t hue = 0;
 
 public:
-    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>& snapshots) override {
+    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>& snapshots, const FrameContext&) override {
         speed = audio.energy * 0.5f;
         position += speed;
         hue = (uint8_t)(audio.energy * 255);
     }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            float phase = fmod(position + i * 0.1f, count);
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
+        for (int k = 0; k < length; ++k) {
+            float phase = fmod(position + (begin + k) * 0.1f, count);
             uint8_t bright = 128 + 127 * sin8((uint8_t)(phase));
-            leds[i] += CHSV(hue, 255, bright);
+            out[k] += CHSV(hue, 255, bright);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "EnergyPulseRiverLayer"; }
 };
 
@@ -40,19 +47,33 @@ class DominantBandFireTrailLayer : public VisualLayer {
     float heat = 0.0f;
 
 public:
-    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         center = map(audio.dominantBand, 0, NUM_SAMPLES / 2, 0, 255);
         heat = audio.bass + audio.treble;
     }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            float dist = abs(i - center * count / 255.0f);
+    // Intensity falls to zero 20% of the strip either side of the band
+    int spans(int count, PixelSpan* out) const override {
+        float c = center * count / 255.0f;
+        float reach = count * 0.2f;
+        out[0] = PixelSpan::of((int)floorf(c - reach), (int)ceilf(c + reach) + 1, count);
+        return out[0].empty() ? 0 : 1;
+    }
+
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
+        for (int k = 0; k < length; ++k) {
+            float dist = abs(begin + k - center * count / 255.0f);
             float intensity = max(0.0f, 1.0f - dist / (count * 0.2f));
-            leds[i] += CHSV(20 + heat * 40, 255, intensity * 255);
+            out[k] += CHSV(20 + heat * 40, 255, intensity * 255);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "DominantBandFireTrailLayer"; }
 };
 
@@ -61,10 +82,17 @@ class NoiseFloorMistLayer : public VisualLayer {
     uint8_t baseHue = 160;
 
 public:
-    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         baseHue = 160 + audio.noiseFloor * 80;
     }
 
+    uint32_t renderKey() const override { return 0x100 | baseHue; }
+
+    bool uniformColor(CRGB& color) const override {
+        color = CHSV(baseHue, 100, 20);
+        return true;
+    }
+
     void render(CRGB* leds, int count) override {
         for (int i = 0; i < count; ++i) {
             leds[i] += CHSV(baseHue, 100, 20);
@@ -76,17 +104,20 @@ public:
 
 // === Layer 7: Dynamics Flicker Storm ===
 class DynamicsFlickerStormLayer : public VisualLayer {
+    SparseSampler sparks;
+
 public:
-    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&) override {
+    DynamicsFlickerStormLayer() { sparks.seed("DynamicsFlickerStorm"); }
+
+    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         opacity = audio.dynamics * 1.0f;
     }
 
     void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            if (random8() < opacity * 255) {
-                leds[i] += CHSV(random8(), 200, random8(32, 128));
-            }
-        }
+        Pcg32& rng = sparks.generator();
+        sparks.forEach(count, opacity, [&](int i) {
+            leds[i] += CHSV(rng.next8(), 200, rng.next8(32, 128));
+        });
     }
 
     const char* getName() const override { return "DynamicsFlickerStormLayer"; }
@@ -96,59 +127,86 @@ class TriwaveBeatLayer : public VisualLayer {
     bool direction = true;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        if (now.beatDetected) direction = !direction;
-    }
+    EventMask wakeEvents() const override { return eventBit(AudioEventType::BEAT); }
+    void onEvent(const AudioEvent&) override { direction = !direction; }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; i++) {
-            float pos = (float)i / count;
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {}
+
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
+        for (int k = 0; k < length; k++) {
+            float pos = (float)(begin + k) / count;
             float tri = direction
                 ? abs(fmod(pos * 2.0, 1.0f) * 2.0f - 1.0f)
                 : abs(fmod((1.0f - pos) * 2.0, 1.0f) * 2.0f - 1.0f);
             uint8_t brightness = tri * 255;
-            leds[i] += CHSV(200, 255, brightness);
+            out[k] += CHSV(200, 255, brightness);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "TriwaveBeatLayer"; }
 };
 
 class EnergySpiralLayer : public VisualLayer {
+    float hueOffset = 0.0f;
+    float spin = 0.0f;
+
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        // No dynamic state needed, just reacts
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext& frame) override {
+        // Driven by the clock alone
+        hueOffset = fmod(frame.nowMs / 50.0, 255);
+        spin = fmod(frame.nowMs / 200.0, 6.283185307179586);
     }
 
-    void render(CRGB* leds, int count) override {
-        float hueOffset = fmod(millis() / 50.0, 255);
-        for (int i = 0; i < count; ++i) {
-            float phase = float(i) / count * 6.2831f; // 2π
-            float amp = sin(phase + millis() / 200.0) * 0.5 + 0.5;
-            leds[i] += CHSV(hueOffset + amp * 100, 255, amp * 100);
+    // One sine period over the whole strip
+    uint8_t maxLodShift() const override { return 3; }
+
+    void renderSampled(CRGB* out, int samples, int count, int step) override {
+        for (int k = 0; k < samples; ++k) {
+            float phase = float(k * step) / count * 6.2831f; // 2π
+            float amp = sin(phase + spin) * 0.5 + 0.5;
+            out[k] += CHSV(hueOffset + amp * 100, 255, amp * 100);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSampled(leds, count, count, 1);
+    }
+
     const char* getName() const override { return "EnergySpiralLayer"; }
 };
 class DominantBandTrailLayer : public VisualLayer {
     int pos = 0;
     float decay = 0.9f;
+    float* heat = nullptr;
+    int heatSize = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        pos = map(now.dominantBand, 0, NUM_SAMPLES / 2, 0, LED_0_NUM - 1); // assuming LED_0_NUM is longest strip
+    void attach(int ledCount, ScratchAllocator& scratch) override {
+        heat = scratch.allocate<float>(ledCount);
+        heatSize = heat ? ledCount : 0;
     }
 
-    void render(CRGB* leds, int count) override {
-        static float heat[LED_0_NUM] = {};
-        for (int i = 0; i < count; ++i) {
+    // Decays per step rather than per render, so the trail's length doesn't
+    // depend on the frame rate
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
+        pos = map(now.dominantBand, 0, NUM_SAMPLES / 2, 0, heatSize - 1);
+        for (int i = 0; i < heatSize; ++i) {
             heat[i] *= decay;
         }
-        if (pos >= 0 && pos < count) {
+        if (pos >= 0 && pos < heatSize) {
             heat[pos] = 1.0f;
         }
-        for (int i = 0; i < count; ++i) {
+    }
+
+    void render(CRGB* leds, int count) override {
+        int n = min(count, heatSize);
+        for (int i = 0; i < n; ++i) {
             leds[i] += CHSV(140, 255, heat[i] * 255);
         }
     }
@@ -160,7 +218,10 @@ class WaveformScribbleLayer : public VisualLayer {
 private:
     int16_t localWaveform[256]; // Store a local copy instead of just a pointer
     int waveformSize = 0;
-    unsigned long lastUpdateTime = 0;
+    int stepsSinceCopy = 0;
+
+    // Copy at most every 50 ms of layer steps to avoid rapid memory accesses
+    static constexpr int copyEverySteps = 50000 / LED_FRAME_INTERVAL_US;
 
 public:
     // Constructor
@@ -169,18 +230,14 @@ public:
         memset(localWaveform, 0, sizeof(localWaveform));
         name = "WaveformScribble"; // Set a name for this layer
         waveformSize = 0;
-        lastUpdateTime = 0;
     }
 
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        // Only update at most every 50ms to avoid rapid memory accesses
-        unsigned long currentTime = millis();
-        if (currentTime - lastUpdateTime < 50) {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
+        if (waveformSize > 0 && ++stepsSinceCopy < copyEverySteps) {
             return;
         }
-        
-        lastUpdateTime = currentTime;
-        
+        stepsSinceCopy = 0;
+
         // Safely copy waveform data to our local buffer
         if (now.waveform != nullptr && now.waveformSize > 0) {
             int sizeToCopy = min(now.waveformSize, (int)sizeof(localWaveform)/sizeof(localWaveform[0]));
@@ -219,46 +276,85 @@ public:
         spectrumCentroid = 0;
     }
 
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         ripplePhase += 0.1f;
         spectrumCentroid = now.spectrumCentroid;
     }
 
-    void render(CRGB* leds, int count) override {
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
         int center = map(spectrumCentroid, 0, NUM_SAMPLES / 2, 0, count - 1);
-        for (int i = 0; i < count; ++i) {
-            float dist = abs(i - center);
+        for (int k = 0; k < length; ++k) {
+            float dist = abs(begin + k - center);
             float pulse = sin(dist * 0.3f + ripplePhase);
             uint8_t bright = constrain((pulse + 1.0f) * 128, 0, 255);
-            leds[i] += CHSV(center, 255, bright);
+            out[k] += CHSV(center, 255, bright);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "CentroidRadianceLayer"; }
 };
 
 class BassShockwaveLayer : public VisualLayer {
     int frame = 999;
+    int ledCount = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        if (now.beatDetected && now.bass > 0.8f) {
-            frame = 0;
+    void attach(int count, ScratchAllocator&) override { ledCount = count; }
+
+    // A wave starts on a beat with heavy bass
+    EventMask wakeEvents() const override { return eventBit(AudioEventType::BEAT); }
+    void onEvent(const AudioEvent& event) override {
+        if (event.value > 0.8f) frame = -1;
+    }
+
+    // Both fronts are past the strip's ends
+    bool dormant() const override { return frame * 0.8f > ledCount / 2 + 12; }
+
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
+        frame++;
+    }
+
+    // Two fronts moving out from the centre. Past 12 pixels from a front the
+    // gaussian is under 1/255 and rounds to black.
+    int spans(int count, PixelSpan* out) const override {
+        const int halfWidth = 12;
+        int center = count / 2;
+        int radius = (int)(frame * 0.8f);
+        PixelSpan left = PixelSpan::of(center - radius - halfWidth, center - radius + halfWidth + 1, count);
+        PixelSpan right = PixelSpan::of(center + radius - halfWidth, center + radius + halfWidth + 1, count);
+        int n = 0;
+        if (!left.empty()) out[n++] = left;
+        if (right.empty()) return n;
+        if (n && right.begin <= out[0].end) {
+            out[0].end = max(out[0].end, right.end);
         } else {
-            frame++;
+            out[n++] = right;
         }
+        return n;
     }
 
-    void render(CRGB* leds, int count) override {
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
         float radius = frame * 0.8f;
-        for (int i = 0; i < count; ++i) {
-            float dist = abs(i - count / 2);
+        for (int k = 0; k < length; ++k) {
+            float dist = abs(begin + k - count / 2);
             float wave = exp(-pow((dist - radius) / 5.0f, 2));
             uint8_t brightness = wave * 255;
-            leds[i] += CHSV(0, 255, brightness);
+            out[k] += CHSV(0, 255, brightness);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "BassShockwaveLayer"; }
 };
 
@@ -267,30 +363,44 @@ class WormholeVortexLayer : public VisualLayer {
     float offset = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         offset += now.dynamics * 0.5f;
     }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            float angle = offset + i * 0.15f;
+    // Hue climbs 6 per pixel
+    uint8_t maxLodShift() const override { return 2; }
+
+    void renderSampled(CRGB* out, int samples, int count, int step) override {
+        for (int k = 0; k < samples; ++k) {
+            float angle = offset + k * step * 0.15f;
             uint8_t hue = fmod(angle * 40, 255);
-            leds[i] += CHSV(hue, 255, 80);
+            out[k] += CHSV(hue, 255, 80);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSampled(leds, count, count, 1);
+    }
+
     const char* getName() const override { return "WormholeVortexLayer"; }
 };
 
 class EnergyFogLayer : public VisualLayer {
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         energy = now.energy; // Store energy from audio features
+        hue = map(energy, 0, 2000, 160, 220);  // Bluish fog to white-hot
+        brightness = constrain(energy / 10, 0, 180);
+    }
+
+    uint32_t renderKey() const override { return 0x10000 | (hue << 8) | brightness; }
+
+    bool uniformColor(CRGB& color) const override {
+        color = CHSV(hue, 40, brightness);
+        return true;
     }
 
     void render(CRGB* leds, int count) override {
-        uint8_t hue = map(energy, 0, 2000, 160, 220);  // Bluish fog to white-hot
-        uint8_t brightness = constrain(energy / 10, 0, 180);
         for (int i = 0; i < count; ++i) {
             leds[i] += CHSV(hue, 40, brightness);
         }
@@ -299,12 +409,14 @@ public:
     const char* getName() const override { return "EnergyFogLayer"; }
 private:
     float energy = 0;
+    uint8_t hue = 160;
+    uint8_t brightness = 0;
 };
 class LoudnessLightningLayer : public VisualLayer {
     float lastLoudness = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         lastLoudness = now.loudness;
     }
 
@@ -324,7 +436,7 @@ class MoodMemoryArcLayer : public VisualLayer {
     float avgMood = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history, const FrameContext&) override {
         if (history.size() < 10) return;
         float moodSum = 0;
         for (int i = 0; i < 10; ++i) {
@@ -333,13 +445,24 @@ public:
         avgMood = moodSum / 10.0f;
     }
 
-    void render(CRGB* leds, int count) override {
+    int spans(int count, PixelSpan* out) const override {
+        out[0] = PixelSpan::of(count / 4, count * 3 / 4, count);
+        return out[0].empty() ? 0 : 1;
+    }
+
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
         uint8_t hue = map(avgMood * 100, 0, 100, 0, 255);
-        for (int i = count / 4; i < count * 3 / 4; ++i) {
-            leds[i] += CHSV(hue, 180, 80);
+        for (int k = 0; k < length; ++k) {
+            out[k] += CHSV(hue, 180, 80);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "MoodMemoryArcLayer"; }
 };
 class TrebleSparkleLayer : public VisualLayer {
@@ -347,7 +470,7 @@ private:
     float treble = 0.0f;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
         treble = now.treble;
     }
 
@@ -373,19 +496,32 @@ public:
         opacity = 0.6f;
     }
 
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& history, const FrameContext&) override {
         pos = now.spectrumCentroid / float(NUM_SAMPLES / 2); // normalized 0–1
     }
 
-    void render(CRGB* leds, int count) override {
+    // 128 - dist * 6 reaches zero 22 pixels out
+    int spans(int count, PixelSpan* out) const override {
         int center = int(pos * count);
-        for (int i = 0; i < count; ++i) {
-            float dist = fabs(i - center);
+        out[0] = PixelSpan::of(center - 21, center + 22, count);
+        return out[0].empty() ? 0 : 1;
+    }
+
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
+        int center = int(pos * count);
+        for (int k = 0; k < length; ++k) {
+            float dist = fabs(begin + k - center);
             uint8_t brightness = qsub8(128, dist * 6);
-            leds[i] += CHSV(170, 200, brightness);
+            out[k] += CHSV(170, 200, brightness);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "CentroidGlowWipeLayer"; }
 };
 
@@ -396,7 +532,10 @@ public:
         opacity = 0.4f;
     }
 
-    void update(const AudioFeatures&, const std::deque<AudioSnapshot>&) override {}
+    void update(const AudioFeatures&, const std::deque<AudioSnapshot>&, const FrameContext&) override {}
+
+    // Never changes
+    uint32_t renderKey() const override { return 1; }
 
     void render(CRGB* leds, int count) override {
         int bands = 16;
@@ -418,7 +557,7 @@ public:
 class BPMWavePulseLayer : public VisualLayer {
 private:
     float position = 0.0f;
-    unsigned long lastUpdate = 0;
+    uint32_t beatCount = 0;
 
 public:
     BPMWavePulseLayer() {
@@ -426,28 +565,39 @@ public:
         opacity = 0.5f;
     }
 
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        unsigned long nowMillis = millis();
-        float interval = now.bpm > 0.0f ? 60000.0f / now.bpm : 500.0f;
-
-        if (nowMillis - lastUpdate > interval) {
-            lastUpdate = nowMillis;
+    // Restarts with each beat of the frame's beat clock
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext& frame) override {
+        if (frame.beatCount != beatCount) {
+            beatCount = frame.beatCount;
             position = 0.0f;
         }
 
         position += 0.05f;  // Move pulse forward
     }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            float dist = fabs(i - (position * count));
+    // 255 - dist * 15 reaches zero 17 pixels out
+    int spans(int count, PixelSpan* out) const override {
+        float center = position * count;
+        out[0] = PixelSpan::of((int)ceilf(center - 17.0f), (int)floorf(center + 17.0f) + 1, count);
+        return out[0].empty() ? 0 : 1;
+    }
+
+    bool fusable() const override { return true; }
+
+    void renderChunk(CRGB* out, int begin, int length, int count) override {
+        for (int k = 0; k < length; ++k) {
+            float dist = fabs(begin + k - (position * count));
             uint8_t brightness = qsub8(255, dist * 15);
             if (brightness > 0) {
-                leds[i] += CHSV(200, 255, brightness);
+                out[k] += CHSV(200, 255, brightness);
             }
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSpans(leds, count);
+    }
+
     const char* getName() const override { return "BPMWavePulseLayer"; }
 };
 
@@ -455,28 +605,29 @@ public:
 class BeatFlashSparkLayer : public VisualLayer {
 private:
     uint8_t cooldown = 0;
+    SparseSampler sparks;
 
 public:
     BeatFlashSparkLayer() {
         name = "BeatFlashSpark";
         opacity = 0.7f;
+        sparks.seed("BeatFlashSpark");
     }
 
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&) override {
-        if (now.beatDetected) {
-            cooldown = 10;
-        } else if (cooldown > 0) {
-            cooldown--;
-        }
+    EventMask wakeEvents() const override { return eventBit(AudioEventType::BEAT); }
+    void onEvent(const AudioEvent&) override { cooldown = 11; }
+    bool dormant() const override { return cooldown == 0; }
+
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>&, const FrameContext&) override {
+        if (cooldown > 0) cooldown--;
     }
 
     void render(CRGB* leds, int count) override {
         if (cooldown == 0) return;
-        for (int i = 0; i < count; ++i) {
-            if (random8() < 20) {
-                leds[i] += CHSV(random8(), 255, 255);
-            }
-        }
+        Pcg32& rng = sparks.generator();
+        sparks.forEach(count, 20 / 256.0f, [&](int i) {
+            leds[i] += CHSV(rng.next8(), 255, 255);
+        });
     }
 
     const char* getName() const override { return "BeatFlashSparkLayer"; }
@@ -488,25 +639,37 @@ class BPMBeatFlashLayer : public VisualLayer {
         float lastBPM = 0;
     
     public:
-        void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& snapshots) override {
-            if (now.beatDetected) {
-                flashTime = 5;
-                lastBPM = now.bpm;
-            }
-            else if (flashTime > 0) {
-                flashTime--;
-            }
+        EventMask wakeEvents() const override { return eventBit(AudioEventType::BEAT); }
+        void onEvent(const AudioEvent& event) override {
+            flashTime = 6;
+            lastBPM = event.bpm;
+        }
+        bool dormant() const override { return flashTime <= 0; }
+
+        void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& snapshots, const FrameContext&) override {
+            if (flashTime > 0) flashTime--;
         }
     
-        void render(CRGB* leds, int count) override {
-            if (flashTime > 0) {
-                CHSV color = CHSV((int)lastBPM % 255, 255, 100);
-                for (int i = 0; i < count; ++i) {
-                    leds[i] += color;
-                }
+        // Nothing to draw between flashes
+        int spans(int count, PixelSpan* out) const override {
+            if (flashTime <= 0) return 0;
+            out[0] = PixelSpan::of(0, count, count);
+            return 1;
+        }
+
+        bool fusable() const override { return true; }
+
+        void renderChunk(CRGB* out, int begin, int length, int count) override {
+            CRGB color = CHSV((int)lastBPM % 255, 255, 100);
+            for (int k = 0; k < length; ++k) {
+                out[k] += color;
             }
         }
 
+        void render(CRGB* leds, int count) override {
+            renderSpans(leds, count);
+        }
+
         const char* getName() const override { return "BPMBeatFlashLayer"; }
     };
 
@@ -517,18 +680,25 @@ private:
     float hueBase = 0;
 
 public:
-    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& snapshots) override {
+    void update(const AudioFeatures& now, const std::deque<AudioSnapshot>& snapshots, const FrameContext&) override {
         hueBase = now.spectrumCentroid * 2;  // Map to hue
         flow += now.volume * 3.0f;
     }
 
-    void render(CRGB* leds, int count) override {
-        for (int i = 0; i < count; ++i) {
-            float wave = sin8((i * 4 + (int)flow) % 256);
-            leds[i] += CHSV(hueBase, 255, wave);
+    // sin8 wave with a 64-pixel period
+    uint8_t maxLodShift() const override { return 2; }
+
+    void renderSampled(CRGB* out, int samples, int count, int step) override {
+        for (int k = 0; k < samples; ++k) {
+            float wave = sin8((k * step * 4 + (int)flow) % 256);
+            out[k] += CHSV(hueBase, 255, wave);
         }
     }
 
+    void render(CRGB* leds, int count) override {
+        renderSampled(leds, count, count, 1);
+    }
+
     const char* getName() const override { return "CentroidColorFlowLayer"; }
 };
 
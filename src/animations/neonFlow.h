@@ -3,14 +3,18 @@
 
 #include "Animation.h"
 #include "../audio/AudioFeatures.h"
+#include "../utils/SparseSampler.h"
 
 class NeonFlowAnimation : public Animation {
 private:
     float hueOffset = 0;
     uint8_t sparkleCountdown = 0;
+    SparseSampler shimmer;
 
 public:
-    void update(CRGB* leds, int n, const AudioFeatures& audio) override {
+    NeonFlowAnimation() { shimmer.seed("NeonFlow"); }
+
+    void update(CRGB* leds, int n, const AudioFeatures& audio, const FrameContext& frame) override {
         // Base color from spectrum centroid (shifted a bit)
         uint8_t baseHue = fmod(audio.spectrumCentroid * 2.0 + hueOffset, 255);
 
@@ -24,25 +28,25 @@ public:
         int sparkles = constrain(audio.energy / 30, 0, 20);
 
         // Smooth rainbow background
+        unsigned long drift = frame.nowMs / 10;
         for (int i = 0; i < n; ++i) {
-            float offset = sin8((i * audio.treble * 8) + millis() / 10) / 255.0;
+            float offset = sin8((i * audio.treble * 8) + drift) / 255.0;
             uint8_t hue = baseHue + offset * 32;
             uint8_t brightness = baseBrightness - (i % 16);
             leds[i] = CHSV(hue, 255, brightness);
         }
 
         // Add bass pulses as wave
+        uint8_t scroll = frame.ramp8(4);
         for (int i = 0; i < n; ++i) {
-            float wave = sin8((millis() / 4 + i * 5)) / 255.0;
+            float wave = sin8((scroll + i * 5)) / 255.0;
             leds[i] += CHSV(0, 255, audio.bass * wave * 255);
         }
 
-        // Midrange shimmer
-        for (int i = 0; i < n; i += 5) {
-            if (random(0, 100) < audio.mid * 80) {
-                leds[i] += CHSV(96, 255, 200);
-            }
-        }
+        // Midrange shimmer on every 5th LED
+        shimmer.forEach((n + 4) / 5, audio.mid * 0.8f, [&](int slot) {
+            leds[slot * 5] += CHSV(96, 255, 200);
+        });
 
         // Treble sparkles
         for (int i = 0; i < sparkles; ++i) {
@@ -76,6 +80,6 @@ public:
         }
 
         // Advance hue slowly
-        hueOffset += audio.loudness / 100.0f;
+        hueOffset += audio.loudness / 100.0f * frame.steps;
     }
 };
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+#include "../config/Config.h"
+#include "AudioFeatures.h"
+
+// Discrete moments in the music and the show, published once each on the
+// EventBus (src/core/EventBus.h) instead of every consumer polling flags.
+enum class AudioEventType : uint8_t {
+    BEAT,
+    BASS_HIT,
+    PEAK,
+    SILENCE_START,
+    SILENCE_END,
+    MOOD_CHANGE,
+    SCENE_CHANGE,
+    COUNT
+};
+
+using EventMask = uint8_t;
+
+constexpr EventMask eventBit(AudioEventType type) {
+    return (EventMask)(1u << static_cast<uint8_t>(type));
+}
+
+struct AudioEvent {
+    AudioEventType type = AudioEventType::BEAT;
+    uint32_t timeMs = 0;
+    // BEAT and BASS_HIT: bass level; PEAK: peak amplitude; MOOD_CHANGE: the new
+    // MoodType; SCENE_CHANGE and silence: 0
+    float value = 0.0f;
+    float bpm = 0.0f;       // Tempo estimate when published
+};
+
+inline const char* audioEventName(AudioEventType type) {
+    switch (type) {
+        case AudioEventType::BEAT: return "beat";
+        case AudioEventType::BASS_HIT: return "bass_hit";
+        case AudioEventType::PEAK: return "peak";
+        case AudioEventType::SILENCE_START: return "silence_start";
+        case AudioEventType::SILENCE_END: return "silence_end";
+        case AudioEventType::MOOD_CHANGE: return "mood_change";
+        case AudioEventType::SCENE_CHANGE: return "scene_change";
+        default: return "unknown";
+    }
+}
+
+// Turns each analysis result into events. Edge-triggered: a peak fires when the
+// amplitude crosses EVENT_PEAK_THRESHOLD and re-arms once it falls back below
+// 90% of it; silence starts after EVENT_SILENCE_HOLD_MS without signal and ends
+// on the first block with signal.
+class AudioEventDetector {
+public:
+    // Calls emit(event) for each event in f, in a fixed order
+    template<typename Emit>
+    void process(const AudioFeatures& f, uint32_t nowMs, Emit&& emit) {
+        AudioEvent e;
+        e.timeMs = nowMs;
+        e.bpm = f.bpm;
+
+        if (f.beatDetected) emit(make(e, AudioEventType::BEAT, f.bass));
+        if (f.bassHits != lastBassHits) {
+            if (f.bassHits > lastBassHits) emit(make(e, AudioEventType::BASS_HIT, f.bass));
+            lastBassHits = f.bassHits;
+        }
+
+        if (!peakHigh && f.peak >= EVENT_PEAK_THRESHOLD) {
+            peakHigh = true;
+            emit(make(e, AudioEventType::PEAK, f.peak));
+        } else if (peakHigh && f.peak < EVENT_PEAK_THRESHOLD * 0.9f) {
+            peakHigh = false;
+        }
+
+        if (f.signalPresence) {
+            quietSinceMs = nowMs;
+            if (silent) {
+                silent = false;
+                emit(make(e, AudioEventType::SILENCE_END, 0.0f));
+            }
+        } else if (!silent && nowMs - quietSinceMs >= EVENT_SILENCE_HOLD_MS) {
+            silent = true;
+            emit(make(e, AudioEventType::SILENCE_START, 0.0f));
+        }
+    }
+
+    bool isSilent() const { return silent; }
+
+private:
+    int lastBassHits = 0;
+    bool peakHigh = false;
+    bool silent = false;
+    uint32_t quietSinceMs = 0;
+
+    static AudioEvent make(AudioEvent e, AudioEventType type, float value) {
+        e.type = type;
+        e.value = value;
+        return e;
+    }
+};
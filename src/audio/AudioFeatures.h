@@ -32,4 +32,6 @@ struct AudioFeatures {
 
     float centroid = 0.0f;          //  ??
     float frequency = 0.0f;         //  frequency
+
+    uint32_t timestamp = 0;         // micros() when the analysed block was complete
 };
@@ -47,7 +47,6 @@ public:
 
 // MoodClassifier.h
 #pragma once
-#include <String.h>
 #include "AudioHistoryTracker.h"
 
 class MoodClassifier {
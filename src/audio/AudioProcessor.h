@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Arduino.h>
+#ifndef NATIVE_BUILD
 #include <driver/i2s.h>
+#endif
 #include <arduinoFFT.h>
 #include "../config/Config.h"
 #include "../core/Debug.h"
@@ -32,6 +34,13 @@ private:
     unsigned long lastBeatTime = 0;
     float currentBPM = 0.0;
     int bassHitCount = 0;
+    int captureFill = 0;
+
+    void storeSample(int i, float normalized) {
+        vReal[i] = normalized;
+        vImag[i] = 0.0;
+        buffer[i] = static_cast<int16_t>(normalized * 32767);
+    }
 
 public:
     AudioProcessor() {
@@ -42,6 +51,7 @@ public:
         delete FFT;
     }
 
+#ifndef NATIVE_BUILD
     void begin() {
         i2s_config_t i2s_config = {
             .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX),
@@ -69,27 +79,40 @@ public:
         i2s_zero_dma_buffer(I2S_PORT);
     }
 
-    void captureAudio() {
+    // Non-blocking: drains whatever the I2S DMA buffers hold and returns true once a
+    // full NUM_SAMPLES block is ready for analyzeAudio(). LED frames can run in
+    // between instead of waiting ~12 ms for every block.
+    bool captureAudio() {
         static int32_t i2sBuffer[NUM_SAMPLES];
-        memset(i2sBuffer, 0, sizeof(i2sBuffer));
         size_t bytesRead = 0;
+        size_t wanted = (NUM_SAMPLES - captureFill) * sizeof(int32_t);
 
-        esp_err_t result = i2s_read(I2S_PORT, (void*)i2sBuffer, sizeof(i2sBuffer), &bytesRead, 100 / portTICK_PERIOD_MS);
-        if (result != ESP_OK) return;
+        esp_err_t result = i2s_read(I2S_PORT, (void*)i2sBuffer, wanted, &bytesRead, 0);
+        if (result != ESP_OK) return false;
 
         int samplesRead = bytesRead / sizeof(int32_t);
-        for (int i = 0; i < samplesRead && i < NUM_SAMPLES; i++) {
+        for (int i = 0; i < samplesRead && captureFill < NUM_SAMPLES; i++) {
             int32_t sample = i2sBuffer[i] >> 8;
             if (sample & 0x800000) sample |= ~0xFFFFFF;
-            float normalized = sample / 8388608.0f;
-            vReal[i] = normalized;
-            vImag[i] = 0.0;
-            buffer[i] = static_cast<int16_t>(normalized * 32767);
+            storeSample(captureFill++, sample / 8388608.0f);
+        }
+        if (captureFill < NUM_SAMPLES) return false;
+        captureFill = 0;
+        return true;
+    }
+#endif
+
+    // Feed normalized (-1..1) mono samples in place of an I2S capture.
+    // Used by the native build to drive analysis from recorded audio.
+    void loadSamples(const float* samples, int count) {
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            storeSample(i, i < count ? samples[i] : 0.0f);
         }
     }
 
     AudioFeatures analyzeAudio() {
         AudioFeatures features = {};
+        features.timestamp = micros();
         
         // Make sure buffer is properly initialized before assigning
         if (buffer != nullptr) {
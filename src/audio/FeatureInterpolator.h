@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include "../config/Config.h"
+#include "AudioFeatures.h"
+
+// Turns the stepwise AudioFeatures stream (one update per analysis block) into a
+// continuous signal the LEDs can sample at their own, usually higher, frame rate.
+//
+// push():   per-feature attack/release smoothing, one-pole with time constants in
+//           ms so the response is independent of the analysis rate.
+// sample(): the smoothed value, extrapolated along its last slope to the time the
+//           frame will be shown (at most one analysis interval ahead, so a stalled
+//           analysis holds still instead of running away).
+// Integer fields, the waveform and flags come from the latest analysis; a beat is
+// reported on exactly one LED frame however many frames one analysis block spans.
+class FeatureInterpolator {
+public:
+    struct Channel {
+        float AudioFeatures::* field;
+        float attackMs;
+        float releaseMs;
+        bool extrapolate;
+    };
+
+    static constexpr int channelCount = 14;
+    static constexpr Channel channels[channelCount] = {
+        { &AudioFeatures::volume,           5.0f,   120.0f, true  },
+        { &AudioFeatures::loudness,         10.0f,  250.0f, true  },
+        { &AudioFeatures::peak,             0.0f,   150.0f, false },
+        { &AudioFeatures::average,          20.0f,  200.0f, true  },
+        { &AudioFeatures::agcLevel,         200.0f, 200.0f, false },
+        { &AudioFeatures::bass,             5.0f,   150.0f, true  },
+        { &AudioFeatures::mid,              10.0f,  150.0f, true  },
+        { &AudioFeatures::treble,           5.0f,   100.0f, true  },
+        { &AudioFeatures::spectrumCentroid, 40.0f,  200.0f, true  },
+        { &AudioFeatures::dynamics,         10.0f,  200.0f, true  },
+        { &AudioFeatures::energy,           5.0f,   150.0f, true  },
+        { &AudioFeatures::bpm,              500.0f, 500.0f, false },
+        { &AudioFeatures::noiseFloor,       200.0f, 1000.0f, false },
+        { &AudioFeatures::frequency,        20.0f,  100.0f, true  },
+    };
+
+    // Feed one analysis result, stamped with the micros() it describes
+    void push(const AudioFeatures& f, uint32_t timeUs) {
+        float dtMs = hasData ? (uint32_t)(timeUs - lastPushUs) / 1000.0f : 0.0f;
+        for (int i = 0; i < channelCount; ++i) {
+            const Channel& c = channels[i];
+            float target = f.*(c.field);
+            previous[i] = smoothed[i];
+            if (!hasData) {
+                smoothed[i] = previous[i] = target;
+                continue;
+            }
+            float tau = target > smoothed[i] ? c.attackMs : c.releaseMs;
+            smoothed[i] += coefficient(dtMs, tau) * (target - smoothed[i]);
+        }
+
+        float spectrumAlpha = coefficient(dtMs, FEATURE_SPECTRUM_SMOOTHING_MS);
+        for (int bin = 0; bin < NUM_SAMPLES / 2; ++bin) {
+            spectrum[bin] = hasData ? spectrum[bin] + spectrumAlpha * (f.spectrum[bin] - spectrum[bin]) : f.spectrum[bin];
+        }
+
+        if (hasData && dtMs > 0) intervalUs = timeUs - lastPushUs;
+        latest = f;
+        pendingBeat |= f.beatDetected;
+        lastPushUs = timeUs;
+        hasData = true;
+    }
+
+    // Features for an LED frame that will be visible at showTimeUs
+    void sample(uint32_t showTimeUs, AudioFeatures& out) {
+        // Copy only the non-interpolated fields, not the 2 KB spectrum twice
+        out.dominantBand = latest.dominantBand;
+        out.bassHits = latest.bassHits;
+        out.signalPresence = latest.signalPresence;
+        out.waveform = latest.waveform;
+        out.waveformSize = latest.waveformSize;
+        out.centroid = latest.centroid;
+        out.timestamp = showTimeUs;
+        out.beatDetected = pendingBeat;
+        pendingBeat = false;
+        if (!hasData) return;
+
+        float ahead = 0.0f;
+        int32_t sinceUpdate = (int32_t)(showTimeUs - lastPushUs);
+        if (sinceUpdate > 0 && intervalUs > 0) {
+            ahead = min((float)sinceUpdate, (float)intervalUs) / intervalUs;
+        }
+        for (int i = 0; i < channelCount; ++i) {
+            float v = smoothed[i];
+            if (channels[i].extrapolate) {
+                v += (smoothed[i] - previous[i]) * ahead;
+                if (v < 0.0f) v = 0.0f;   // every extrapolated feature is non-negative
+            }
+            out.*(channels[i].field) = v;
+        }
+        memcpy(out.spectrum, spectrum, sizeof(spectrum));
+    }
+
+    bool ready() const { return hasData; }
+    uint32_t lastUpdateMicros() const { return lastPushUs; }
+    uint32_t analysisIntervalMicros() const { return intervalUs; }
+
+private:
+    static float coefficient(float dtMs, float tauMs) {
+        if (tauMs <= 0.0f) return 1.0f;
+        return 1.0f - expf(-dtMs / tauMs);
+    }
+
+    AudioFeatures latest;
+    float smoothed[channelCount] = {};
+    float previous[channelCount] = {};
+    double spectrum[NUM_SAMPLES / 2] = {};
+    uint32_t lastPushUs = 0;
+    uint32_t intervalUs = 0;
+    bool pendingBeat = false;
+    bool hasData = false;
+};
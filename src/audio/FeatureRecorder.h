@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#ifdef NATIVE_BUILD
+#include <cstdio>
+#else
+#include <LittleFS.h>
+#endif
+#include "../config/Config.h"
+#include "../core/Debug.h"
+#include "AudioFeatures.h"
+#include "FeatureStream.h"
+
+// Writes the per-frame AudioFeatures stream to a file while the show runs.
+// Frames are batched in RAM and flushed in blocks to keep flash writes cheap.
+// Every FEATURE_RECORDING_SYNC_MS the batch is written and the file synced, because
+// on device the show usually ends with the power going off and end() never runs.
+// On device the file lives on LittleFS; the native build writes to the host filesystem.
+class FeatureRecorder {
+private:
+    static constexpr size_t bufferSize = 2048;
+
+    FeatureStreamEncoder encoder;
+    uint8_t buffer[bufferSize];
+    size_t used = 0;
+    uint32_t framesRecorded = 0;
+    uint32_t lastSyncMs = 0;
+    bool recording = false;
+
+#ifdef NATIVE_BUILD
+    FILE* file = nullptr;
+#else
+    File file;
+#endif
+
+    bool writeOut(const uint8_t* data, size_t len) {
+#ifdef NATIVE_BUILD
+        return fwrite(data, 1, len, file) == len;
+#else
+        return file.write(data, len) == len;
+#endif
+    }
+
+    void flush() {
+        if (used == 0) return;
+        bool written = writeOut(buffer, used);
+        used = 0;
+        if (!written) {
+            Debug::log(Debug::ERROR, "FeatureRecorder: write failed (storage full?), recording stopped");
+            end();
+        }
+    }
+
+    // The batch to the file and the file's data and size to storage
+    void sync() {
+        flush();
+        if (!recording) return;
+#ifdef NATIVE_BUILD
+        fflush(file);
+#else
+        file.flush();
+#endif
+    }
+
+public:
+    ~FeatureRecorder() { end(); }
+
+    bool begin(const char* path) {
+        end();
+#ifdef NATIVE_BUILD
+        file = fopen(path, "wb");
+        if (!file) return false;
+#else
+        if (!LittleFS.begin(true)) return false;
+        file = LittleFS.open(path, "w");
+        if (!file) return false;
+#endif
+        encoder = FeatureStreamEncoder();
+        framesRecorded = 0;
+        lastSyncMs = millis();
+        recording = true;
+        used = encoder.encodeHeader(buffer);
+        Debug::logf(Debug::INFO, "FeatureRecorder: recording to %s", path);
+        return true;
+    }
+
+    void record(const AudioFeatures& features, unsigned long timestampMs) {
+        if (!recording) return;
+        if (used + FeatureStream::maxFrameBytes > bufferSize) flush();
+        if (!recording) return;
+        used += encoder.encode(features, (uint32_t)timestampMs, buffer + used);
+        framesRecorded++;
+        if ((uint32_t)timestampMs - lastSyncMs >= FEATURE_RECORDING_SYNC_MS) {
+            lastSyncMs = (uint32_t)timestampMs;
+            sync();
+        }
+    }
+
+    void end() {
+        if (!recording) return;
+        recording = false;
+        if (used > 0) writeOut(buffer, used);
+        used = 0;
+#ifdef NATIVE_BUILD
+        fclose(file);
+        file = nullptr;
+#else
+        file.close();
+#endif
+    }
+
+    bool isRecording() const { return recording; }
+    uint32_t getFramesRecorded() const { return framesRecorded; }
+};
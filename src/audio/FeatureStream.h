@@ -0,0 +1,214 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include "../config/Config.h"
+#include "AudioFeatures.h"
+
+// Compact per-frame encoding of AudioFeatures for recording and deterministic replay.
+//
+// Header: "GGAF" | u8 version | u8 bandCount
+// Frame:  u8 flags | varint dt (ms) | zigzag varint delta per quantised scalar
+//         | zigzag varint delta per log-magnitude band
+//
+// Scalars are fixed-point quantised; the spectrum is reduced to FFT_BANDS log-spaced
+// bands stored as 8-bit log magnitudes. Every keyframeInterval frames deltas are
+// taken against zero so a reader can resync. The waveform is not recorded.
+class FeatureStream {
+public:
+    static constexpr uint8_t version = 1;
+    static constexpr int headerSize = 6;
+    static constexpr int bandCount = FFT_BANDS;
+    static constexpr int floatFieldCount = 14;
+    static constexpr int scalarCount = floatFieldCount + 2; // + dominantBand, bassHits
+    static constexpr int maxFrameBytes = 1 + 5 + (scalarCount + bandCount) * 5;
+    static constexpr uint16_t keyframeInterval = 256;
+
+    enum Flags : uint8_t {
+        FLAG_BEAT = 1,
+        FLAG_PRESENCE = 2,
+        FLAG_KEYFRAME = 4
+    };
+
+    struct FloatField {
+        float AudioFeatures::* field;
+        float scale;
+    };
+
+    static constexpr FloatField floatFields[floatFieldCount] = {
+        { &AudioFeatures::volume, 10000.0f },
+        { &AudioFeatures::loudness, 100.0f },
+        { &AudioFeatures::peak, 10000.0f },
+        { &AudioFeatures::average, 10000.0f },
+        { &AudioFeatures::agcLevel, 1000.0f },
+        { &AudioFeatures::bass, 10000.0f },
+        { &AudioFeatures::mid, 10000.0f },
+        { &AudioFeatures::treble, 10000.0f },
+        { &AudioFeatures::spectrumCentroid, 100.0f },
+        { &AudioFeatures::dynamics, 10000.0f },
+        { &AudioFeatures::energy, 10.0f },
+        { &AudioFeatures::bpm, 100.0f },
+        { &AudioFeatures::noiseFloor, 10000.0f },
+        { &AudioFeatures::frequency, 1.0f },
+    };
+
+    // First spectrum bin of each band; bandEdges[bandCount] is one past the last bin.
+    static const uint16_t* bandEdges() {
+        static uint16_t edges[bandCount + 1] = {};
+        if (edges[bandCount] == 0) {
+            const int bins = NUM_SAMPLES / 2;
+            edges[0] = 1; // bin 0 is DC
+            for (int k = 1; k <= bandCount; ++k) {
+                int edge = (int)lroundf(powf((float)bins, (float)k / bandCount));
+                edges[k] = (uint16_t)constrain(edge, edges[k - 1] + 1, bins);
+            }
+            edges[bandCount] = bins;
+        }
+        return edges;
+    }
+
+    static void quantise(const AudioFeatures& f, int32_t* scalars, uint8_t* bands) {
+        for (int i = 0; i < floatFieldCount; ++i) {
+            scalars[i] = (int32_t)lroundf(f.*(floatFields[i].field) * floatFields[i].scale);
+        }
+        scalars[floatFieldCount] = f.dominantBand;
+        scalars[floatFieldCount + 1] = f.bassHits;
+
+        const uint16_t* edges = bandEdges();
+        for (int k = 0; k < bandCount; ++k) {
+            double sum = 0;
+            for (int bin = edges[k]; bin < edges[k + 1]; ++bin) sum += f.spectrum[bin];
+            float mag = (float)(sum / (edges[k + 1] - edges[k]));
+            bands[k] = (uint8_t)constrain(lroundf(log2f(1.0f + mag) * 16.0f), 0L, 255L);
+        }
+    }
+
+    static void dequantise(const int32_t* scalars, const uint8_t* bands, uint8_t flags, AudioFeatures& f) {
+        f = AudioFeatures();
+        for (int i = 0; i < floatFieldCount; ++i) {
+            f.*(floatFields[i].field) = scalars[i] / floatFields[i].scale;
+        }
+        f.dominantBand = scalars[floatFieldCount];
+        f.bassHits = scalars[floatFieldCount + 1];
+        f.beatDetected = flags & FLAG_BEAT;
+        f.signalPresence = flags & FLAG_PRESENCE;
+
+        const uint16_t* edges = bandEdges();
+        for (int k = 0; k < bandCount; ++k) {
+            double mag = exp2f(bands[k] / 16.0f) - 1.0f;
+            for (int bin = edges[k]; bin < edges[k + 1]; ++bin) f.spectrum[bin] = mag;
+        }
+    }
+
+    static uint8_t* putVarint(uint8_t* out, uint32_t v) {
+        while (v >= 0x80) {
+            *out++ = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        *out++ = (uint8_t)v;
+        return out;
+    }
+
+    // Returns nullptr if the varint runs past `end`.
+    static const uint8_t* getVarint(const uint8_t* in, const uint8_t* end, uint32_t& v) {
+        v = 0;
+        for (int shift = 0; in < end && shift < 35; shift += 7) {
+            uint8_t byte = *in++;
+            v |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return in;
+        }
+        return nullptr;
+    }
+
+    static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    static int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+};
+
+class FeatureStreamEncoder {
+private:
+    int32_t prevScalars[FeatureStream::scalarCount] = {};
+    uint8_t prevBands[FeatureStream::bandCount] = {};
+    uint32_t prevTimestamp = 0;
+    uint32_t frameIndex = 0;
+
+public:
+    size_t encodeHeader(uint8_t* out) const {
+        memcpy(out, "GGAF", 4);
+        out[4] = FeatureStream::version;
+        out[5] = FeatureStream::bandCount;
+        return FeatureStream::headerSize;
+    }
+
+    // Writes at most FeatureStream::maxFrameBytes.
+    size_t encode(const AudioFeatures& f, uint32_t timestampMs, uint8_t* out) {
+        int32_t scalars[FeatureStream::scalarCount];
+        uint8_t bands[FeatureStream::bandCount];
+        FeatureStream::quantise(f, scalars, bands);
+
+        bool keyframe = frameIndex++ % FeatureStream::keyframeInterval == 0;
+        if (keyframe) {
+            memset(prevScalars, 0, sizeof(prevScalars));
+            memset(prevBands, 0, sizeof(prevBands));
+            prevTimestamp = 0;
+        }
+
+        uint8_t* p = out;
+        *p++ = (f.beatDetected ? FeatureStream::FLAG_BEAT : 0)
+             | (f.signalPresence ? FeatureStream::FLAG_PRESENCE : 0)
+             | (keyframe ? FeatureStream::FLAG_KEYFRAME : 0);
+        p = FeatureStream::putVarint(p, timestampMs - prevTimestamp);
+        for (int i = 0; i < FeatureStream::scalarCount; ++i) {
+            p = FeatureStream::putVarint(p, FeatureStream::zigzag(scalars[i] - prevScalars[i]));
+            prevScalars[i] = scalars[i];
+        }
+        for (int k = 0; k < FeatureStream::bandCount; ++k) {
+            p = FeatureStream::putVarint(p, FeatureStream::zigzag((int32_t)bands[k] - prevBands[k]));
+            prevBands[k] = bands[k];
+        }
+        prevTimestamp = timestampMs;
+        return p - out;
+    }
+};
+
+class FeatureStreamDecoder {
+private:
+    int32_t prevScalars[FeatureStream::scalarCount] = {};
+    uint8_t prevBands[FeatureStream::bandCount] = {};
+    uint32_t prevTimestamp = 0;
+
+public:
+    static bool validHeader(const uint8_t* in, size_t len) {
+        return len >= (size_t)FeatureStream::headerSize && memcmp(in, "GGAF", 4) == 0
+            && in[4] == FeatureStream::version && in[5] == FeatureStream::bandCount;
+    }
+
+    // Returns bytes consumed, or 0 if `len` does not hold a complete frame.
+    size_t decode(const uint8_t* in, size_t len, AudioFeatures& f, uint32_t& timestampMs) {
+        const uint8_t* end = in + len;
+        const uint8_t* p = in;
+        if (p >= end) return 0;
+        uint8_t flags = *p++;
+
+        int32_t scalars[FeatureStream::scalarCount];
+        uint8_t bands[FeatureStream::bandCount];
+        bool keyframe = flags & FeatureStream::FLAG_KEYFRAME;
+
+        uint32_t v;
+        if (!(p = FeatureStream::getVarint(p, end, v))) return 0;
+        uint32_t timestamp = (keyframe ? 0 : prevTimestamp) + v;
+        for (int i = 0; i < FeatureStream::scalarCount; ++i) {
+            if (!(p = FeatureStream::getVarint(p, end, v))) return 0;
+            scalars[i] = (keyframe ? 0 : prevScalars[i]) + FeatureStream::unzigzag(v);
+        }
+        for (int k = 0; k < FeatureStream::bandCount; ++k) {
+            if (!(p = FeatureStream::getVarint(p, end, v))) return 0;
+            bands[k] = (uint8_t)((keyframe ? 0 : prevBands[k]) + FeatureStream::unzigzag(v));
+        }
+
+        memcpy(prevScalars, scalars, sizeof(prevScalars));
+        memcpy(prevBands, bands, sizeof(prevBands));
+        prevTimestamp = timestampMs = timestamp;
+        FeatureStream::dequantise(scalars, bands, flags, f);
+        return p - in;
+    }
+};
@@ -0,0 +1,1041 @@
+// Render benchmark (PlatformIO env:native-bench).
+//
+// Instantiates every layer from layerCatalog and every animation from
+// animationCatalog and drives each one for a fixed number of frames at several
+// strip lengths, with synthetic and (optionally) recorded AudioFeatures.
+// Per case it reports time per pixel and per frame, heap allocations per frame and
+// peak stack use. Results go to stdout as a table and to a JSON file.
+// ParticleSystem is also run on its own at several particle counts, kept full by
+// re-emitting, to give the per-particle cost and how many fit the layer budget.
+// Layers and animations that allow a reduced level of detail are run at each
+// LOD against a full-resolution twin, for speedup and per-channel error.
+// A stack of fusable layers is composited through LayerManager twice, fused and
+// one pass per layer, for the speedup of chunked evaluation and a check that
+// both give the same pixels. Each compiled scene is run against its dynamic
+// twin (catalog animation plus LayerManager) the same way.
+// EventBus publishes are timed against 1, 4 and EVENT_BUS_MAX_SUBSCRIBERS
+// layer stacks of beat-driven layers, for the cost per event and per delivery.
+// A rig of uneven strips, each with the fusable stack, is rendered on one lane
+// and on every RenderWorkers lane, for the speedup, the scaling efficiency
+// (speedup per lane) and a check that the pixels don't change.
+//
+// Usage: program [--replay features.ggaf] [--json bench.json] [--frames N]
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <pthread.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../config/Config.h"
+#include "../audio/AudioFeatures.h"
+#include "../audio/AudioSnapshot.h"
+#include "../core/FrameContext.h"
+#include "../core/EventBus.h"
+#include "../core/RenderWorkers.h"
+#include "../animations/AnimationCatalog.h"
+#include "../animations/LayerCatalog.h"
+#include "../animations/ParticleSystem.h"
+#include "../animations/LevelOfDetail.h"
+#include "../scenes/LayerManager.h"
+#include "../scenes/CompiledSceneCatalog.h"
+#include "../sim/FeatureReplaySource.h"
+
+// ==== Allocation counting ====
+// Every form of operator new and delete is replaced, so none falls back to the
+// library's and GCC sees matching pairs. The counters are atomic because the
+// worker cases allocate from several threads.
+
+static std::atomic<bool> countAllocations{ false };
+static std::atomic<size_t> allocationCount{ 0 };
+static std::atomic<size_t> allocationBytes{ 0 };
+
+static void* countedAlloc(size_t size, size_t align) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (size == 0) size = 1;
+    if (align <= alignof(std::max_align_t)) return malloc(size);
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+// Kept out of line so GCC doesn't see free() paired with a new-expression
+__attribute__((noinline)) static void countedFree(void* p) noexcept { free(p); }
+
+void* operator new(size_t size) {
+    if (void* p = countedAlloc(size, 0)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = countedAlloc(size, (size_t)align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlloc(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlloc(size, (size_t)align); }
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
+
+// ==== Inputs ====
+
+static const int stripLengths[] = { 60, 300, 1000, 3000 };
+static const int particleCounts[] = { 1000, 4000, 16000 };
+static const int particleStripLength = 3000;
+static const int stackStripLengths[] = { 300, 1000, 3000 };
+static const int eventSubscriberCounts[] = { 1, 4, EVENT_BUS_MAX_SUBSCRIBERS };
+static const int eventStripLength = 300;
+// Four beat-driven layers and one that takes no events
+static const char* const eventLayers[] = { "BeatFlashSpark", "BPMBeatFlash", "BassShockwave", "TriwaveBeat", "CentroidRadiance" };
+// Uneven on purpose: one strip is half the work, so balancing matters
+static const int parallelStripLengths[] = { 3000, 1000, 1000, 300, 300, 300, 60, 60 };
+
+// Fusable layers composited in the stack cases; one screen-blended below full opacity
+struct StackLayer { const char* name; LayerBlend blend; uint8_t opacity; };
+static const StackLayer stackLayers[] = {
+    { "CentroidRadiance", LayerBlend::ADD, 255 },
+    { "EnergyPulseRiver", LayerBlend::ADD, 255 },
+    { "TriwaveBeat", LayerBlend::SCREEN, 200 },
+    { "DominantBandFireTrail", LayerBlend::ADD, 255 },
+    { "BassShockwave", LayerBlend::ADD, 255 },
+    { "BPMWavePulse", LayerBlend::ADD, 255 },
+};
+static const unsigned long frameMicros = NUM_SAMPLES * 1000000UL / SAMPLE_RATE;
+
+// The frame's context with a dt of one reference frame, so every layer steps
+// exactly once per bench frame whatever frameMicros is
+static const FrameContext& benchFrame(FrameClock& clock, int frame, const AudioFeatures& f) {
+    return clock.tick(millis(), (uint32_t)frame * LED_FRAME_INTERVAL_US, f, 1.0f);
+}
+
+// Deterministic 120 BPM-ish groove: beats every 43 frames, sweeping bands and centroid
+static std::vector<AudioFeatures> syntheticFeatures(int frames) {
+    std::vector<AudioFeatures> out(frames);
+    for (int i = 0; i < frames; ++i) {
+        AudioFeatures& f = out[i];
+        float t = i * frameMicros / 1000000.0f;
+        float beatPhase = (i % 43) / 43.0f;
+        float kick = expf(-beatPhase * 6.0f);
+        f.volume = 0.2f + 0.5f * kick;
+        f.loudness = f.volume * 100.0f;
+        f.peak = std::min(1.0f, f.volume * 1.6f);
+        f.average = f.volume * 0.6f;
+        f.bass = kick;
+        f.mid = 0.5f + 0.4f * sinf(t * 1.3f);
+        f.treble = 0.5f + 0.5f * sinf(t * 3.7f);
+        f.spectrumCentroid = 40.0f + 30.0f * sinf(t * 0.5f);
+        f.dominantBand = 2 + (i / 7) % 60;
+        f.dynamics = f.peak - f.average;
+        f.energy = 400.0f + 1200.0f * kick;
+        f.beatDetected = (i % 43) == 0;
+        f.bpm = 120.0f;
+        f.bassHits = i / 43;
+        f.noiseFloor = 0.02f;
+        f.signalPresence = true;
+        f.frequency = f.dominantBand * (float)SAMPLE_RATE / NUM_SAMPLES;
+        for (int bin = 1; bin < NUM_SAMPLES / 2; ++bin) {
+            f.spectrum[bin] = (kick * 40.0f) / bin + 0.5f * (1.0f + sinf(bin * 0.2f + t));
+        }
+    }
+    return out;
+}
+
+static std::vector<AudioFeatures> recordedFeatures(const char* path, int frames) {
+    std::vector<AudioFeatures> out;
+    FeatureReplaySource replay;
+    if (!replay.open(path)) return out;
+    AudioFeatures f;
+    uint32_t ts;
+    while ((int)out.size() < frames && replay.next(f, ts)) out.push_back(f);
+    return out;
+}
+
+// ==== Cases ====
+
+struct BenchCase {
+    std::string kind;
+    std::string name;
+    std::string input;
+    int leds = 0;
+    const LayerMeta* layer = nullptr;
+    const AnimationMeta* animation = nullptr;
+    int particles = 0;             // ParticleSystem case when > 0
+    int lodShift = 0;              // Level-of-detail case when > 0
+    bool stack = false;            // Fused against per-layer compositing
+    int subscribers = 0;           // EventBus case when > 0
+    int lanes = 0;                 // RenderWorkers case when > 0
+    const CompiledSceneMeta* compiled = nullptr;
+    const std::vector<AudioFeatures>* features = nullptr;
+    int frames = 0;
+
+    // Results
+    double nsPerFrame = 0;
+    double nsPerPixel = 0;
+    double allocsPerFrame = 0;
+    double bytesPerFrame = 0;
+    size_t peakStack = 0;
+    double lodSpeedup = 0;         // Full-resolution time / reduced time
+    double lodErrorMean = 0;       // Mean absolute per-channel difference, 0-255
+    int lodErrorMax = 0;
+    double fusedSpeedup = 0;       // Per-layer compositing time / fused time
+    bool fusedIdentical = false;   // Both gave the same pixels every frame
+    double compiledSpeedup = 0;    // Dynamic scene time / compiled scene time
+    bool compiledIdentical = false;
+    double eventNs = 0;            // Per publish, all subscribers included
+    double deliveryNs = 0;         // Per handler call
+    double parallelSpeedup = 0;    // One lane's time / all lanes' time
+    double scalingEfficiency = 0;  // parallelSpeedup per lane, 1.0 is perfect
+    bool parallelIdentical = false;
+    uint32_t steals = 0;           // Jobs taken from another lane's queue, all-lanes passes
+};
+
+// Steady-state ParticleSystem cost: top up to capacity, step, render
+static void runParticleCase(BenchCase& c) {
+    std::vector<CRGB> leds(c.leds);
+    const int warmup = 20;
+
+    randomSeed(1);
+    size_t scratchBytes = LedArena::alignUp((size_t)c.particles * ParticleSystem::bytesPerParticle + 64);
+    LedArena arena;
+    arena.begin(scratchBytes, false);
+    ArenaRegion region;
+    region.init(arena.reserve(scratchBytes), scratchBytes);
+    ScratchAllocator scratch(&region, true);
+    ParticleSystem particles;
+    particles.attach(c.leds, c.particles, scratch);
+
+    double totalNs = 0;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        fill_solid(leds.data(), c.leds, CRGB::Black);
+
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        while (particles.size() < particles.getCapacity()) {
+            particles.emit((float)random(c.leds), (int)random(-100, 101) / 50.0f, (uint8_t)random(256), 2);
+        }
+        particles.step(0.98f);
+        particles.render(leds.data(), c.leds);
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    c.nsPerFrame = totalNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+}
+
+// The same layer or animation twice in lockstep: one at full resolution, one
+// sampled at the case's LOD and interpolated up. Both see the same input and clock.
+static void runLodCase(BenchCase& c) {
+    std::vector<CRGB> full(c.leds), reduced(c.leds);
+    std::vector<CRGB> samples(lodSamples(c.leds, c.lodShift));
+    std::deque<AudioSnapshot> history;
+    const int warmup = 20;
+    const std::vector<AudioFeatures>& input = *c.features;
+    const int step = 1 << c.lodShift;
+
+    randomSeed(1);
+    random16_set_seed(1);
+    native::setMicros(0);
+
+    size_t scratchBytes = LedArena::alignUp((size_t)c.leds * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(2 * scratchBytes, false);
+    ArenaRegion regions[2];
+    regions[0].init(arena.reserve(scratchBytes), scratchBytes);
+    regions[1].init(arena.reserve(scratchBytes), scratchBytes);
+    ScratchAllocator scratchFull(&regions[0], true), scratchReduced(&regions[1], true);
+
+    VisualLayer* layers[2] = { nullptr, nullptr };
+    Animation* animations[2] = { nullptr, nullptr };
+    for (int i = 0; i < 2; ++i) {
+        ScratchAllocator& scratch = i == 0 ? scratchFull : scratchReduced;
+        if (c.layer) { layers[i] = c.layer->create(); layers[i]->attach(c.leds, scratch); }
+        if (c.animation) { animations[i] = c.animation->create(); animations[i]->attach(c.leds, scratch); }
+    }
+
+    double fullNs = 0, reducedNs = 0, errorSum = 0;
+    int errorMax = 0;
+    FrameClock clock;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        const AudioFeatures& f = input[frame % input.size()];
+        const FrameContext& context = benchFrame(clock, frame, f);
+        AudioSnapshot snap = { f.volume, f.bass, f.mid, f.treble, f.spectrumCentroid, f.bpm,
+                               f.energy, f.dynamics, f.beatDetected, millis() };
+        history.push_back(snap);
+        if (history.size() > 1500) history.pop_front();
+        fill_solid(full.data(), c.leds, CRGB::Black);
+        fill_solid(reduced.data(), c.leds, CRGB::Black);
+
+        auto start = std::chrono::steady_clock::now();
+        if (c.layer) {
+            layers[0]->update(f, history, context);
+            layers[0]->render(full.data(), c.leds);
+        } else {
+            animations[0]->update(full.data(), c.leds, f, context);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        if (c.layer) {
+            layers[1]->update(f, history, context);
+            fill_solid(samples.data(), samples.size(), CRGB::Black);
+            layers[1]->renderSampled(samples.data(), samples.size(), c.leds, step);
+            lodUpsampleAdd(samples.data(), c.lodShift, reduced.data(), c.leds);
+        } else {
+            animations[1]->updateSampled(samples.data(), samples.size(), c.leds, step, f, context);
+            lodUpsampleCopy(samples.data(), c.lodShift, reduced.data(), c.leds);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if (frame >= warmup) {
+            fullNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            reducedNs += std::chrono::duration<double, std::nano>(end - middle).count();
+            for (int i = 0; i < c.leds; ++i) {
+                for (int ch = 0; ch < 3; ++ch) {
+                    int diff = abs((int)full[i][ch] - (int)reduced[i][ch]);
+                    errorSum += diff;
+                    if (diff > errorMax) errorMax = diff;
+                }
+            }
+        }
+        native::advanceMicros(frameMicros);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        delete layers[i];
+        delete animations[i];
+    }
+
+    c.nsPerFrame = reducedNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+    c.lodSpeedup = reducedNs > 0 ? fullNs / reducedNs : 0;
+    c.lodErrorMean = errorSum / ((double)c.frames * c.leds * 3);
+    c.lodErrorMax = errorMax;
+}
+
+// One pass of the stack case through LayerManager; returns render ns over the
+// timed frames and folds every frame's pixels into hash
+static double runStackPass(const BenchCase& c, bool fused, uint32_t& hash) {
+    std::vector<CRGB> leds(c.leds);
+    std::deque<AudioSnapshot> history;
+    const int warmup = 20;
+    const std::vector<AudioFeatures>& input = *c.features;
+
+    randomSeed(1);
+    random16_set_seed(1);
+    native::setMicros(0);
+
+    size_t scratchBytes = LedArena::alignUp((size_t)c.leds * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(scratchBytes, false);
+    ArenaRegion region;
+    region.init(arena.reserve(scratchBytes), scratchBytes);
+
+    LayerManager manager;
+    manager.setLEDs(leds.data(), c.leds);
+    manager.setScratch(&region);
+    manager.setRenderBudget(0);
+    manager.setFusedRendering(fused);
+    for (const StackLayer& entry : stackLayers) {
+        SceneLayerSpec spec;
+        spec.blend = entry.blend;
+        spec.opacity = entry.opacity;
+        for (size_t i = 0; i < sizeof(layerCatalog) / sizeof(layerCatalog[0]); ++i) {
+            if (!strcmp(layerCatalog[i].name, entry.name)) spec.catalogIndex = (int16_t)i;
+        }
+        manager.addSceneLayer(spec);
+    }
+
+    double totalNs = 0;
+    hash = 2166136261u;
+    FrameClock clock;
+    AudioEventDetector events;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        const AudioFeatures& f = input[frame % input.size()];
+        const FrameContext& context = benchFrame(clock, frame, f);
+        events.process(f, millis(), [&](const AudioEvent& e) { manager.dispatchEvent(e); });
+        AudioSnapshot snap = { f.volume, f.bass, f.mid, f.treble, f.spectrumCentroid, f.bpm,
+                               f.energy, f.dynamics, f.beatDetected, millis() };
+        history.push_back(snap);
+        if (history.size() > 1500) history.pop_front();
+        fill_solid(leds.data(), c.leds, CRGB::Black);
+        manager.updateLayers(f, history, context);
+
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        manager.renderLayers();
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(leds.data());
+        for (size_t i = 0; i < leds.size() * sizeof(CRGB); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+        native::advanceMicros(frameMicros);
+    }
+    manager.clearLayers();
+    return totalNs;
+}
+
+// Alternating rounds, best of each, so host noise doesn't favour one mode
+static void runStackCase(BenchCase& c) {
+    const int rounds = 3;
+    uint32_t fusedHash = 0, separateHash = 0;
+    double fusedNs = 0, separateNs = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double fused = runStackPass(c, true, fusedHash);
+        double separate = runStackPass(c, false, separateHash);
+        fusedNs = round == 0 ? fused : std::min(fusedNs, fused);
+        separateNs = round == 0 ? separate : std::min(separateNs, separate);
+    }
+    c.nsPerFrame = fusedNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+    c.fusedSpeedup = fusedNs > 0 ? separateNs / fusedNs : 0;
+    c.fusedIdentical = fusedHash == separateHash;
+}
+
+// The case's compiled scene, or its dynamic twin: the same animation from the
+// catalog and the same layers through LayerManager. Timed like runStackPass,
+// animation and layers together.
+static double runScenePass(const BenchCase& c, bool compiled, uint32_t& hash) {
+    std::vector<CRGB> leds(c.leds);
+    std::deque<AudioSnapshot> history;
+    const int warmup = 20;
+    const std::vector<AudioFeatures>& input = *c.features;
+
+    // Catalog entries for the twin's layers, found before seeding since
+    // constructors may draw from random()
+    int16_t catalogIndex[SCENE_MAX_LAYERS];
+    int layerCount = 0;
+    if (!compiled) {
+        CompiledScene* probe = c.compiled->create();
+        const char* names[SCENE_MAX_LAYERS];
+        layerCount = probe->layerNames(names, SCENE_MAX_LAYERS);
+        for (int i = 0; i < layerCount; ++i) {
+            catalogIndex[i] = -1;
+            for (size_t k = 0; k < layerCatalog.size(); ++k) {
+                VisualLayer* layer = layerCatalog[k].create();
+                if (!strcmp(layer->getName(), names[i])) catalogIndex[i] = (int16_t)k;
+                delete layer;
+            }
+        }
+        delete probe;
+    }
+
+    randomSeed(1);
+    random16_set_seed(1);
+    native::setMicros(0);
+
+    size_t scratchBytes = LedArena::alignUp((size_t)c.leds * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(scratchBytes, false);
+    ArenaRegion region;
+    region.init(arena.reserve(scratchBytes), scratchBytes);
+    ScratchAllocator scratch(&region, true);
+
+    CompiledScene* scene = nullptr;
+    Animation* animation = nullptr;
+    LayerManager manager;
+    if (compiled) {
+        scene = c.compiled->create();
+        scene->attach(c.leds, scratch);
+    } else {
+        animation = animationFactory(c.compiled->animation)();
+        animation->attach(c.leds, scratch);
+        manager.setLEDs(leds.data(), c.leds);
+        manager.setScratch(&region);
+        manager.setRenderBudget(0);
+        for (int i = 0; i < layerCount; ++i) {
+            SceneLayerSpec spec;
+            spec.catalogIndex = catalogIndex[i];
+            manager.addSceneLayer(spec);
+        }
+    }
+
+    double totalNs = 0;
+    hash = 2166136261u;
+    FrameClock clock;
+    AudioEventDetector events;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        const AudioFeatures& f = input[frame % input.size()];
+        const FrameContext& context = benchFrame(clock, frame, f);
+        events.process(f, millis(), [&](const AudioEvent& e) {
+            if (scene) scene->dispatchEvent(e);
+            else manager.dispatchEvent(e);
+        });
+        AudioSnapshot snap = { f.volume, f.bass, f.mid, f.treble, f.spectrumCentroid, f.bpm,
+                               f.energy, f.dynamics, f.beatDetected, millis() };
+        history.push_back(snap);
+        if (history.size() > 1500) history.pop_front();
+
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        if (compiled) {
+            scene->drawAnimation(leds.data(), c.leds, f, context);
+            scene->updateLayers(f, history, context);
+            scene->renderLayers(leds.data(), c.leds);
+        } else {
+            animation->update(leds.data(), c.leds, f, context);
+            manager.updateLayers(f, history, context);
+            manager.renderLayers();
+        }
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(leds.data());
+        for (size_t i = 0; i < leds.size() * sizeof(CRGB); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+        native::advanceMicros(frameMicros);
+    }
+    manager.clearLayers();
+    delete animation;
+    delete scene;
+    return totalNs;
+}
+
+static void runCompiledCase(BenchCase& c) {
+    const int rounds = 3;
+    uint32_t compiledHash = 0, dynamicHash = 0;
+    double compiledNs = 0, dynamicNs = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double compiled = runScenePass(c, true, compiledHash);
+        double dynamic = runScenePass(c, false, dynamicHash);
+        compiledNs = round == 0 ? compiled : std::min(compiledNs, compiled);
+        dynamicNs = round == 0 ? dynamic : std::min(dynamicNs, dynamic);
+    }
+    c.nsPerFrame = compiledNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+    c.compiledSpeedup = compiledNs > 0 ? dynamicNs / compiledNs : 0;
+    c.compiledIdentical = compiledHash == dynamicHash;
+}
+
+// One LayerManager per subscriber, each with eventLayers, behind an EventBus.
+// Publishes cycle through every event type; only BEAT wakes the layers.
+static void runEventCase(BenchCase& c) {
+    const int warmup = 20;
+    size_t scratchBytes = LedArena::alignUp((size_t)c.leds * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(scratchBytes * c.subscribers, false);
+    std::vector<CRGB> leds(c.leds);
+    std::vector<ArenaRegion> regions(c.subscribers);
+    std::vector<LayerManager> managers(c.subscribers);
+
+    EventBus bus;
+    for (int s = 0; s < c.subscribers; ++s) {
+        regions[s].init(arena.reserve(scratchBytes), scratchBytes);
+        managers[s].setLEDs(leds.data(), c.leds);
+        managers[s].setScratch(&regions[s]);
+        for (const char* name : eventLayers) {
+            SceneLayerSpec spec;
+            for (size_t i = 0; i < layerCatalog.size(); ++i) {
+                if (!strcmp(layerCatalog[i].name, name)) spec.catalogIndex = (int16_t)i;
+            }
+            managers[s].addSceneLayer(spec);
+        }
+        bus.subscribe(0xFF, [](void* manager, const AudioEvent& e) {
+            static_cast<LayerManager*>(manager)->dispatchEvent(e);
+        }, &managers[s]);
+    }
+
+    const int types = static_cast<int>(AudioEventType::COUNT);
+    AudioEvent event;
+    event.value = 0.9f;
+    event.bpm = 120.0f;
+    double totalNs = 0;
+    uint32_t deliveriesBefore = 0;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        if (frame == warmup) deliveriesBefore = bus.getStats().deliveries;
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < types; ++t) {
+            event.type = static_cast<AudioEventType>(t);
+            bus.publish(event);
+        }
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+    }
+    uint32_t deliveries = bus.getStats().deliveries - deliveriesBefore;
+    for (LayerManager& manager : managers) manager.clearLayers();
+
+    c.eventNs = totalNs / ((double)c.frames * types);
+    c.deliveryNs = deliveries ? totalNs / deliveries : 0;
+    c.nsPerFrame = totalNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+}
+
+// One strip's frame on a render lane, as LEDStripController::renderStripJob
+struct ParallelStrip {
+    LayerManager manager;
+    ArenaRegion region;
+    std::vector<CRGB> leds;
+};
+
+struct ParallelFrame {
+    std::vector<ParallelStrip>* strips;
+    const AudioFeatures* features;
+    const std::deque<AudioSnapshot>* history;
+    const FrameContext* frame;
+};
+
+static void parallelStripJob(void* context, int i) {
+    ParallelFrame& f = *static_cast<ParallelFrame*>(context);
+    ParallelStrip& strip = (*f.strips)[i];
+    fill_solid(strip.leds.data(), (int)strip.leds.size(), CRGB::Black);
+    strip.manager.updateLayers(*f.features, *f.history, *f.frame);
+    strip.manager.renderLayers();
+}
+
+// One pass of the parallel case on `lanes` lanes; returns ns over the timed
+// frames and folds every strip's pixels into hash
+static double runParallelPass(const BenchCase& c, int lanes, uint32_t& hash, uint32_t& steals) {
+    const int stripCount = (int)(sizeof(parallelStripLengths) / sizeof(parallelStripLengths[0]));
+    std::deque<AudioSnapshot> history;
+    const int warmup = 20;
+    const std::vector<AudioFeatures>& input = *c.features;
+
+    randomSeed(1);
+    random16_set_seed(1);
+    native::setMicros(0);
+
+    size_t arenaBytes = 0;
+    for (int length : parallelStripLengths) arenaBytes += LedArena::alignUp((size_t)length * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(arenaBytes, false);
+    std::vector<ParallelStrip> strips(stripCount);
+    for (int i = 0; i < stripCount; ++i) {
+        ParallelStrip& strip = strips[i];
+        size_t scratchBytes = LedArena::alignUp((size_t)parallelStripLengths[i] * LAYER_SCRATCH_BYTES_PER_LED);
+        strip.leds.resize(parallelStripLengths[i]);
+        strip.region.init(arena.reserve(scratchBytes), scratchBytes);
+        strip.manager.setLEDs(strip.leds.data(), parallelStripLengths[i]);
+        strip.manager.setScratch(&strip.region);
+        strip.manager.setRenderBudget(0);
+        for (const StackLayer& entry : stackLayers) {
+            SceneLayerSpec spec;
+            spec.blend = entry.blend;
+            spec.opacity = entry.opacity;
+            for (size_t l = 0; l < layerCatalog.size(); ++l) {
+                if (!strcmp(layerCatalog[l].name, entry.name)) spec.catalogIndex = (int16_t)l;
+            }
+            strip.manager.addSceneLayer(spec);
+        }
+    }
+
+    RenderWorkers workers;
+    workers.begin(lanes);
+    std::vector<uint32_t> predictedUs(stripCount, 0), measuredUs(stripCount, 0);
+
+    double totalNs = 0;
+    hash = 2166136261u;
+    FrameClock clock;
+    AudioEventDetector events;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        const AudioFeatures& f = input[frame % input.size()];
+        const FrameContext& context = benchFrame(clock, frame, f);
+        events.process(f, millis(), [&](const AudioEvent& e) {
+            for (ParallelStrip& strip : strips) strip.manager.dispatchEvent(e);
+        });
+        AudioSnapshot snap = { f.volume, f.bass, f.mid, f.treble, f.spectrumCentroid, f.bpm,
+                               f.energy, f.dynamics, f.beatDetected, millis() };
+        history.push_back(snap);
+        if (history.size() > 1500) history.pop_front();
+        ParallelFrame job = { &strips, &f, &history, &context };
+
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        workers.run(&parallelStripJob, &job, stripCount, predictedUs.data(), measuredUs.data());
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+
+        for (int i = 0; i < stripCount; ++i) {
+            predictedUs[i] = predictedUs[i] ? (predictedUs[i] * 3 + measuredUs[i]) / 4 : measuredUs[i];
+        }
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+        for (const ParallelStrip& strip : strips) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(strip.leds.data());
+            for (size_t i = 0; i < strip.leds.size() * sizeof(CRGB); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        native::advanceMicros(frameMicros);
+    }
+    steals = workers.getStats().steals;
+    workers.end();
+    for (ParallelStrip& strip : strips) strip.manager.clearLayers();
+    return totalNs;
+}
+
+// Alternating rounds, best of each, as runStackCase
+static void runParallelCase(BenchCase& c) {
+    const int rounds = 3;
+    uint32_t serialHash = 0, parallelHash = 0, serialSteals = 0, steals = 0;
+    double serialNs = 0, parallelNs = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double serial = runParallelPass(c, 1, serialHash, serialSteals);
+        double parallel = runParallelPass(c, c.lanes, parallelHash, steals);
+        serialNs = round == 0 ? serial : std::min(serialNs, serial);
+        parallelNs = round == 0 ? parallel : std::min(parallelNs, parallel);
+        c.steals += steals;
+    }
+    c.nsPerFrame = parallelNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+    c.parallelSpeedup = parallelNs > 0 ? serialNs / parallelNs : 0;
+    c.scalingEfficiency = c.parallelSpeedup / c.lanes;
+    c.parallelIdentical = serialHash == parallelHash;
+}
+
+static void runCase(BenchCase& c) {
+    if (c.lanes > 0) {
+        runParallelCase(c);
+        return;
+    }
+    if (c.subscribers > 0) {
+        runEventCase(c);
+        return;
+    }
+    if (c.compiled) {
+        runCompiledCase(c);
+        return;
+    }
+    if (c.stack) {
+        runStackCase(c);
+        return;
+    }
+    if (c.particles > 0) {
+        runParticleCase(c);
+        return;
+    }
+    if (c.lodShift > 0) {
+        runLodCase(c);
+        return;
+    }
+    std::vector<CRGB> leds(c.leds);
+    std::deque<AudioSnapshot> history;
+    const int warmup = 20;
+    const std::vector<AudioFeatures>& input = *c.features;
+
+    randomSeed(1);
+    random16_set_seed(1);
+    native::setMicros(0);
+
+    // Scratch sized as LEDStripController sizes a strip's region
+    size_t scratchBytes = LedArena::alignUp((size_t)c.leds * LAYER_SCRATCH_BYTES_PER_LED);
+    LedArena arena;
+    arena.begin(scratchBytes, false);
+    ArenaRegion region;
+    region.init(arena.reserve(scratchBytes), scratchBytes);
+    ScratchAllocator scratch(&region, true);
+
+    VisualLayer* layer = c.layer ? c.layer->create() : nullptr;
+    Animation* animation = c.animation ? c.animation->create() : nullptr;
+    if (layer) layer->attach(c.leds, scratch);
+    if (animation) animation->attach(c.leds, scratch);
+
+    // Event-driven layers get their events but are timed awake or not, so the
+    // numbers stay the cost of a frame the layer actually draws
+    double totalNs = 0;
+    FrameClock clock;
+    AudioEventDetector events;
+    for (int frame = 0; frame < warmup + c.frames; ++frame) {
+        const AudioFeatures& f = input[frame % input.size()];
+        const FrameContext& context = benchFrame(clock, frame, f);
+        events.process(f, millis(), [&](const AudioEvent& e) {
+            if (layer && (layer->wakeEvents() & eventBit(e.type))) layer->onEvent(e);
+        });
+        AudioSnapshot snap = { f.volume, f.bass, f.mid, f.treble, f.spectrumCentroid, f.bpm,
+                               f.energy, f.dynamics, f.beatDetected, millis() };
+        history.push_back(snap);
+        if (history.size() > 1500) history.pop_front();
+        if (layer) fill_solid(leds.data(), c.leds, CRGB::Black);
+
+        bool timed = frame >= warmup;
+        countAllocations = timed;
+        auto start = std::chrono::steady_clock::now();
+        if (layer) {
+            layer->update(f, history, context);
+            layer->render(leds.data(), c.leds);
+        } else if (animation) {
+            animation->update(leds.data(), c.leds, f, context);
+        }
+        auto end = std::chrono::steady_clock::now();
+        countAllocations = false;
+
+        if (timed) totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+        native::advanceMicros(frameMicros);
+    }
+
+    delete layer;
+    delete animation;
+
+    c.nsPerFrame = totalNs / c.frames;
+    c.nsPerPixel = c.nsPerFrame / c.leds;
+}
+
+// ==== Stack measurement ====
+// Each case runs on a thread whose stack is pre-filled with a pattern; the deepest
+// overwritten byte afterwards gives the high-water mark. An empty case sets the baseline.
+
+static const size_t benchStackSize = 1 << 20;
+static const uint8_t stackPattern = 0xA5;
+
+static void* caseThread(void* arg) {
+    BenchCase* c = static_cast<BenchCase*>(arg);
+    if (c->features) runCase(*c);
+    return nullptr;
+}
+
+static size_t runOnPaintedStack(BenchCase& c) {
+    void* stack = aligned_alloc(4096, benchStackSize);
+    memset(stack, stackPattern, benchStackSize);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, benchStackSize);
+    pthread_t thread;
+    pthread_create(&thread, &attr, caseThread, &c);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+
+    // Stacks grow down: the first modified byte from the bottom marks the peak
+    const uint8_t* bytes = static_cast<const uint8_t*>(stack);
+    size_t untouched = 0;
+    while (untouched < benchStackSize && bytes[untouched] == stackPattern) untouched++;
+    free(stack);
+    return benchStackSize - untouched;
+}
+
+// ==== Output ====
+
+static void writeJson(const char* path, const std::vector<BenchCase>& cases, size_t baselineStack) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return;
+    }
+    fprintf(out, "{\n  \"frame_us\": %lu,\n  \"baseline_stack_bytes\": %zu,\n  \"results\": [\n", frameMicros, baselineStack);
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const BenchCase& c = cases[i];
+        fprintf(out, "    {\"kind\": \"%s\", \"name\": \"%s\", \"input\": \"%s\", \"leds\": %d, \"frames\": %d, "
+                     "\"ns_per_pixel\": %.3f, \"ns_per_frame\": %.1f, \"allocs_per_frame\": %.3f, "
+                     "\"alloc_bytes_per_frame\": %.1f, \"peak_stack_bytes\": %zu, \"particles\": %d, "
+                     "\"lod_shift\": %d, \"lod_speedup\": %.2f, \"lod_error_mean\": %.3f, \"lod_error_max\": %d, "
+                     "\"fused_speedup\": %.2f, \"fused_identical\": %s, "
+                     "\"compiled_speedup\": %.2f, \"compiled_identical\": %s, "
+                     "\"event_subscribers\": %d, \"event_ns\": %.1f, \"event_delivery_ns\": %.1f, "
+                     "\"render_lanes\": %d, \"parallel_speedup\": %.2f, \"scaling_efficiency\": %.2f, "
+                     "\"parallel_identical\": %s}%s\n",
+                c.kind.c_str(), c.name.c_str(), c.input.c_str(), c.leds, c.frames,
+                c.nsPerPixel, c.nsPerFrame, c.allocsPerFrame, c.bytesPerFrame, c.peakStack,
+                c.particles, c.lodShift, c.lodSpeedup, c.lodErrorMean, c.lodErrorMax,
+                c.fusedSpeedup, c.fusedIdentical ? "true" : "false",
+                c.compiledSpeedup, c.compiledIdentical ? "true" : "false",
+                c.subscribers, c.eventNs, c.deliveryNs,
+                c.lanes, c.parallelSpeedup, c.scalingEfficiency, c.parallelIdentical ? "true" : "false",
+                i + 1 < cases.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+}
+
+int main(int argc, char** argv) {
+    const char* replayPath = nullptr;
+    const char* jsonPath = "bench_results.json";
+    int frames = 200;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--replay") && hasValue) replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--json") && hasValue) jsonPath = argv[++i];
+        else if (!strcmp(argv[i], "--frames") && hasValue) frames = std::max(1, atoi(argv[++i]));
+        else {
+            fprintf(stderr, "usage: %s [--replay features.ggaf] [--json bench.json] [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+    native::setSerialMuted(true);
+
+    struct Input { const char* name; std::vector<AudioFeatures> features; };
+    std::vector<Input> inputs;
+    inputs.push_back({ "synthetic", syntheticFeatures(frames + 20) });
+    if (replayPath) {
+        std::vector<AudioFeatures> recorded = recordedFeatures(replayPath, frames + 20);
+        if (recorded.empty()) {
+            fprintf(stderr, "cannot read feature recording: %s\n", replayPath);
+            return 1;
+        }
+        inputs.push_back({ "recorded", std::move(recorded) });
+    }
+
+    std::vector<BenchCase> cases;
+    for (const Input& input : inputs) {
+        for (int leds : stripLengths) {
+            for (const auto& meta : layerCatalog) {
+                BenchCase c;
+                c.kind = "layer"; c.name = meta.name; c.input = input.name; c.leds = leds;
+                c.layer = &meta; c.features = &input.features; c.frames = frames;
+                cases.push_back(c);
+            }
+            for (const auto& meta : animationCatalog) {
+                BenchCase c;
+                c.kind = "animation"; c.name = meta.name; c.input = input.name; c.leds = leds;
+                c.animation = &meta; c.features = &input.features; c.frames = frames;
+                cases.push_back(c);
+            }
+        }
+    }
+
+    // Reduced resolution, every LOD for anything that allows one, on the synthetic input
+    for (int leds : stripLengths) {
+        if (leds < 300) continue;
+        for (int shift = 1; shift <= LOD_MAX_SHIFT; ++shift) {
+            for (const auto& meta : layerCatalog) {
+                VisualLayer* probe = meta.create();
+                bool lod = probe->maxLodShift() > 0;
+                delete probe;
+                if (!lod) continue;
+                BenchCase c;
+                c.kind = "layer-lod"; c.name = meta.name; c.input = "synthetic"; c.leds = leds; c.lodShift = shift;
+                c.layer = &meta; c.features = &inputs[0].features; c.frames = frames;
+                cases.push_back(c);
+            }
+            for (const auto& meta : animationCatalog) {
+                Animation* probe = meta.create();
+                bool lod = probe->maxLodShift() > 0;
+                delete probe;
+                if (!lod) continue;
+                BenchCase c;
+                c.kind = "anim-lod"; c.name = meta.name; c.input = "synthetic"; c.leds = leds; c.lodShift = shift;
+                c.animation = &meta; c.features = &inputs[0].features; c.frames = frames;
+                cases.push_back(c);
+            }
+        }
+    }
+
+    for (int count : particleCounts) {
+        BenchCase c;
+        c.kind = "particles"; c.name = "ParticleSystem"; c.input = "refill"; c.leds = particleStripLength;
+        c.particles = count; c.features = &inputs[0].features; c.frames = frames;
+        cases.push_back(c);
+    }
+
+    for (int leds : stackStripLengths) {
+        BenchCase c;
+        c.kind = "stack"; c.name = "FusedStack"; c.input = "synthetic"; c.leds = leds;
+        c.stack = true; c.features = &inputs[0].features; c.frames = frames;
+        cases.push_back(c);
+    }
+
+    for (int leds : stackStripLengths) {
+        for (const auto& meta : compiledSceneCatalog) {
+            BenchCase c;
+            c.kind = "compiled"; c.name = meta.name; c.input = "synthetic"; c.leds = leds;
+            c.compiled = &meta; c.features = &inputs[0].features; c.frames = frames;
+            cases.push_back(c);
+        }
+    }
+
+    for (int subscribers : eventSubscriberCounts) {
+        BenchCase c;
+        c.kind = "events"; c.name = "EventBus"; c.input = "all-types"; c.leds = eventStripLength;
+        c.subscribers = subscribers; c.features = &inputs[0].features; c.frames = frames;
+        cases.push_back(c);
+    }
+
+    {
+        BenchCase c;
+        c.kind = "parallel"; c.name = "RenderWorkers"; c.input = "synthetic";
+        for (int length : parallelStripLengths) c.leds += length;
+        c.lanes = RenderWorkers::maxLanes; c.features = &inputs[0].features; c.frames = frames;
+        cases.push_back(c);
+    }
+
+    BenchCase baseline;
+    size_t baselineStack = runOnPaintedStack(baseline);
+
+    printf("%-10s %-24s %-10s %5s %10s %12s %8s %8s\n", "kind", "name", "input", "leds", "ns/pixel", "ns/frame", "allocs", "stack");
+    for (BenchCase& c : cases) {
+        size_t allocsBefore = allocationCount;
+        size_t bytesBefore = allocationBytes;
+        size_t stack = runOnPaintedStack(c);
+        c.peakStack = stack > baselineStack ? stack - baselineStack : 0;
+        c.allocsPerFrame = (double)(allocationCount - allocsBefore) / c.frames;
+        c.bytesPerFrame = (double)(allocationBytes - bytesBefore) / c.frames;
+        printf("%-10s %-24s %-10s %5d %10.2f %12.0f %8.2f %8zu\n", c.kind.c_str(), c.name.c_str(), c.input.c_str(),
+               c.leds, c.nsPerPixel, c.nsPerFrame, c.allocsPerFrame, c.peakStack);
+    }
+
+    // Reduced resolution against full: speedup and visual error per level
+    for (const BenchCase& c : cases) {
+        if (c.lodShift == 0) continue;
+        printf("lod %-22s %5d leds 1/%d: %5.2fx faster, error mean %.2f max %d\n", c.name.c_str(), c.leds,
+               1 << c.lodShift, c.lodSpeedup, c.lodErrorMean, c.lodErrorMax);
+    }
+
+    // Chunked evaluation of the fusable stack against a pass per layer
+    for (const BenchCase& c : cases) {
+        if (!c.stack) continue;
+        printf("stack %5d leds, %zu layers: fused %5.2fx faster, output %s\n", c.leds,
+               sizeof(stackLayers) / sizeof(stackLayers[0]), c.fusedSpeedup,
+               c.fusedIdentical ? "identical" : "DIFFERS");
+    }
+
+    // Compiled scenes against the same animation and layers built at runtime
+    for (const BenchCase& c : cases) {
+        if (!c.compiled) continue;
+        printf("compiled %-15s %5d leds: %5.2fx faster than dynamic, output %s\n", c.name.c_str(), c.leds,
+               c.compiledSpeedup, c.compiledIdentical ? "identical" : "DIFFERS");
+    }
+
+    // EventBus dispatch: a frame here is one publish of every event type
+    for (const BenchCase& c : cases) {
+        if (c.subscribers == 0) continue;
+        printf("events %2d subscribers x %zu layers: %7.1f ns/event, %6.1f ns/delivery\n", c.subscribers,
+               sizeof(eventLayers) / sizeof(eventLayers[0]), c.eventNs, c.deliveryNs);
+    }
+
+    // Strips on every render lane against one lane
+    for (const BenchCase& c : cases) {
+        if (c.lanes == 0) continue;
+        printf("parallel %zu strips, %5d leds on %d lanes (%u host cores): %5.2fx faster, scaling efficiency %.0f%%, "
+               "%u steals, output %s\n",
+               sizeof(parallelStripLengths) / sizeof(parallelStripLengths[0]), c.leds, c.lanes,
+               std::thread::hardware_concurrency(), c.parallelSpeedup,
+               c.scalingEfficiency * 100.0, (unsigned)c.steals, c.parallelIdentical ? "identical" : "DIFFERS");
+    }
+
+    // What fits one layer stack's render budget at the measured per-particle cost
+    for (const BenchCase& c : cases) {
+        if (c.particles == 0) continue;
+        double nsPerParticle = c.nsPerFrame / c.particles;
+        printf("particles %6d: %6.2f ns/particle, %d fit in %d us on this host\n", c.particles, nsPerParticle,
+               (int)(LAYER_RENDER_BUDGET_US * 1000.0 / nsPerParticle), LAYER_RENDER_BUDGET_US);
+    }
+
+    writeJson(jsonPath, cases, baselineStack);
+    printf("wrote %zu results to %s\n", cases.size(), jsonPath);
+    return 0;
+}
@@ -23,39 +23,70 @@
 #define FFT_SMOOTHING       0.8f     // Spectral smoothing for more stable bars
 #define FFT_BANDS           16       // Number of bands for visualization/spectrum
 
+// ==== Feature interpolation ====
+#define FEATURE_SPECTRUM_SMOOTHING_MS  60     // One-pole time constant for the FFT bins
+#define FEATURE_SHOW_LEAD_US           1500   // Render for when the frame is on the strip, not when it starts
+
 // ==== Beat Detection ====
 #define BEAT_THRESHOLD      0.05f    // Minimum change in volume to consider beat
 #define MIN_BEAT_INTERVAL   300      // ms between beats (to avoid rapid re-triggers)
 
+// ==== Audio events ====
+#define EVENT_BUS_MAX_SUBSCRIBERS  12      // Fixed subscriber table of the EventBus
+#define EVENT_PEAK_THRESHOLD       0.95f   // Peak amplitude that fires a PEAK event
+#define EVENT_SILENCE_HOLD_MS      1500    // No signal this long fires SILENCE_START
+
 // ==== Display ====
 #define DEFAULT_BRIGHTNESS  150
+#define LED_FRAME_INTERVAL_US  8333   // ~120 FPS, independent of the audio analysis rate
+#define FRAME_MAX_DT_MS        50     // Longest frame step animations see; a stall doesn't make them jump
+#define FRAME_DEFAULT_BEAT_MS  500    // Beat period for FrameContext::beatPhase until a BPM is known
 
+// ==== Output post-processing ====
+#define OUTPUT_GAMMA            2.2f   // 1.0 disables gamma correction
+#define ENABLE_TEMPORAL_DITHER  true   // Recovers low-level steps lost to gamma/brightness
 
-
-// ==== LED ====
-#define LED_0_PIN            25
-#define LED_1_PIN            33
-// #define LED_2_PIN            25
-// #define LED_3_PIN            25
-// #define LED_4_PIN            25
-// #define LED_5_PIN            25
-// #define LED_6_PIN            25
-// #define LED_7_PIN            25
-// #define LED_8_PIN            25
-// #define LED_9_PIN            25
+// ==== Power budget ====
+// Per-LED current model (WS2812B at 5 V): mA per channel at full drive, plus idle draw
+#define POWER_SUPPLY_VOLTS        5.0f
+#define POWER_MA_RED              16
+#define POWER_MA_GREEN            11
+#define POWER_MA_BLUE             15
+#define POWER_MA_IDLE             1
+#define POWER_LIMIT_MA_PER_STRIP  2500   // 0 disables the per-strip cap
+#define POWER_LIMIT_MA_TOTAL      4000   // Whole-rig supply budget, 0 disables
+#define POWER_GAIN_RELEASE        0.02f  // Gain recovery per frame after limiting
 
 
-#define LED_0_NUM 100
-#define LED_1_NUM 10
-#define LED_2_NUM 0
-#define LED_3_NUM 0
-#define LED_4_NUM 0
-#define LED_5_NUM 0
-#define LED_6_NUM 0
-#define LED_7_NUM 0
-#define LED_8_NUM 0
-#define LED_9_NUM 0
 
+// ==== LED ====
+// Strip pins, lengths, colour order and chipset live in StripConfig.h
+#define LAYER_SCRATCH_BYTES_PER_LED  24     // Per-strip layer/animation scratch in the LED arena
+#define LED_ARENA_USE_PSRAM          false  // Place the LED arena in PSRAM when the board has it
+#define LAYER_POOL_SLOTS_PER_STRIP   3      // Preallocated instances per layer class for each strip (two scene slots, overlay)
+#define LAYER_COST_BUDGET            80     // Max summed LayerMeta::cost of one layer stack
+#define LAYER_STACK_RESERVE          16     // Layer instances per stack reserved up front; more still work but reallocate
+#define LAYER_RENDER_BUDGET_US       2500   // Measured layer time per stack per frame before the governor steps in; 0 disables
+#define LAYER_GOVERNOR_RESTORE_RATIO 0.75f  // Restore a layer only while the stack stays under this share of the budget
+#define LAYER_GOVERNOR_HOLD_FRAMES   15     // Frames between governor decisions
+#define LOD_MIN_SAMPLES              150    // Reduced-resolution layers keep at least this many samples per strip
+#define LOD_MAX_SHIFT                3      // Coarsest level of detail: one sample per 8 pixels
+#define LAYER_CACHE_SLOTS            2      // Cached full-strip layer outputs per layer stack
+#define LAYER_FUSED_RENDERING        false  // Draw runs of fusable layers chunk by chunk instead of a pass per layer; no gain measured yet
+#define LAYER_CHUNK_PIXELS           64     // Pixels per chunk in a fused run
+#define LAYER_FUSED_MAX              8      // Layers in one fused run
+#define PARTICLES_PER_LED            0.5f   // Particle capacity of a particle layer, per strip LED
+#define PARTICLE_MAX_PER_SYSTEM      256    // Upper bound on one ParticleSystem, whatever the strip length
+
+// ==== Render lanes ====
+// Strips render in parallel: the loop task is one lane, a helper task the other
+#define RENDER_WORKERS          2      // Lanes; 1 renders everything on the loop task
+#define RENDER_WORKER_CORE      0      // Core of the helper lane (the Arduino loop task runs on core 1)
+#define RENDER_WORKER_PRIORITY  1      // Same as the loop task
+#define RENDER_WORKER_STACK     8192   // Bytes, as the loop task: layers run on either
+#define RENDER_MAX_JOBS         64     // Jobs in one batch
+#define RENDER_CHUNK_PIXELS     256    // Post-processing job size; longer strips are split
+#define RENDER_PARALLEL_MIN_US  100    // Batches predicted cheaper than this stay on the loop task
 
 
 
@@ -63,9 +94,23 @@
 //cant put this in the array, needs to be defined on compile
 #define MIN_SWITCH_INTERVAL 10000
 
+// ==== Scene transitions ====
+#define SCENE_TRANSITION_MS      1500   // Outgoing and incoming scene overlap; 0 switches instantly
+#define TRANSITION_MAX_EXTRA_US  4000   // Per-strip extra frame time before the outgoing scene is frozen
+
+// ==== Scene table ====
+#define SCENE_FILE_PATH       "/scenes.bin"  // Compiled scene table on LittleFS; built-in scenes if missing
+#define SCENE_MAX_LAYERS      6
+#define SCENE_NAME_LENGTH     24
+#define SCENE_HISTORY_LENGTH  3   // Recent scenes the picker avoids repeating
+#define SCENE_PICK_ATTEMPTS   6   // Weighted draws per pick before taking the best tempo/energy fit
+
+
 
 
 
+// ==== SETTINGS ====
+#define SETTINGS_SAVE_DELAY_MS 3000   // Quiet time after the last change before writing NVS
 
 // ==== MEMORY MANAGEMENT ====
 #define ENABLE_HEAP_MONITORING true
@@ -75,6 +120,7 @@
 #define ENCODER_PIN_A      39
 #define ENCODER_PIN_B      38
 #define ENCODER_BTN_PIN    17
+#define ENCODER_STEPS_PER_DETENT 4  // Quadrature transitions per mechanical click
 
 // ==== BUTTON ====
 #define BUTTON_PIN_1         0
@@ -83,11 +129,15 @@
 // ==== OTHER ====
 #define ENABLE_WEB_UI      false        // Enable/disable WebUI
 #define DEBUG_ENABLED      true        // Toggle debug logging
+#define ENABLE_FEATURE_RECORDING false  // Record AudioFeatures to LittleFS for replay
+#define FEATURE_RECORDING_PATH "/features.ggaf"
+#define FEATURE_RECORDING_SYNC_MS 5000   // Write out and sync the recording this often; a power cut loses at most this much
 
 // ==== DISPLAY ====
 #define DISPLAY_WIDTH      240
 #define DISPLAY_HEIGHT     135
 #define DISPLAY_PIN         4
+#define DISPLAY_UPDATE_INTERVAL_MS 250  // Redraw the TFT at ~4 Hz; it is slow and the LEDs must not wait on it
 
 // ==== VISUALIZATION ====
 #define FFT_MAX_SCALE      50.0        // Scale factor for normalizing FFT bars
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <FastLED.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ==== LED STRIPS ====
+// One row per physical strip. Pins and colour order are template arguments to
+// FastLED.addLeds, so this table must be constexpr; LEDStripController expands it
+// at compile time. Add or remove rows freely, there is no fixed strip limit.
+
+enum class LedChipset {
+    WS2811,
+    WS2812,
+    WS2812B,
+    WS2813,
+    SK6812
+};
+
+struct StripConfig {
+    uint8_t pin;
+    uint16_t length;
+    EOrder colorOrder;
+    LedChipset chipset;
+};
+
+constexpr StripConfig stripTable[] = {
+    { 25, 100, GRB, LedChipset::WS2812B },
+    { 33, 10,  GRB, LedChipset::WS2812B },
+};
+
+constexpr size_t stripTableSize = sizeof(stripTable) / sizeof(stripTable[0]);
+
+// First LED of strip `index` inside the shared LED buffer
+constexpr size_t stripOffset(size_t index) {
+    size_t offset = 0;
+    for (size_t i = 0; i < index; ++i) offset += stripTable[i].length;
+    return offset;
+}
+
+constexpr size_t totalLedCount = stripOffset(stripTableSize);
+
+constexpr uint16_t longestStripLength() {
+    uint16_t longest = 0;
+    for (const auto& strip : stripTable) longest = strip.length > longest ? strip.length : longest;
+    return longest;
+}
+
+static_assert(stripTableSize > 0, "stripTable needs at least one strip");
+static_assert(totalLedCount > 0, "stripTable has no LEDs");
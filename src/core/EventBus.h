@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include "../config/Config.h"
+#include "../audio/AudioEvents.h"
+#include "../utils/ProfileClock.h"
+
+// Synchronous publish/subscribe for AudioEvents. Subscribers are a fixed table
+// of plain function pointers with a context, filtered by an EventMask, so a
+// publish is a short loop with no allocation and no virtual call of its own.
+// Events are delivered in the order published, on the publishing thread.
+//
+// Besides callbacks the bus keeps the mask of events fired since the last
+// beginCycle(), for consumers that would rather test a flag.
+class EventBus {
+public:
+    using Handler = void (*)(void* context, const AudioEvent& event);
+
+    struct Stats {
+        uint32_t published[static_cast<int>(AudioEventType::COUNT)] = {};
+        uint32_t deliveries = 0;     // Handler calls
+        uint32_t dispatchUs = 0;     // Summed publish time
+        uint32_t dispatchUsPeak = 0; // Slowest single publish
+    };
+
+    // False when the table is full
+    bool subscribe(EventMask mask, Handler handler, void* context) {
+        if (subscriberCount >= EVENT_BUS_MAX_SUBSCRIBERS || !handler) return false;
+        subscribers[subscriberCount++] = { mask, handler, context };
+        return true;
+    }
+
+    void unsubscribe(void* context) {
+        int kept = 0;
+        for (int i = 0; i < subscriberCount; ++i) {
+            if (subscribers[i].context != context) subscribers[kept++] = subscribers[i];
+        }
+        subscriberCount = kept;
+    }
+
+    void publish(const AudioEvent& event) {
+        const EventMask bit = eventBit(event.type);
+        uint32_t start = profileMicros();
+        firedMask |= bit;
+        stats.published[static_cast<int>(event.type)]++;
+        for (int i = 0; i < subscriberCount; ++i) {
+            if (subscribers[i].mask & bit) {
+                subscribers[i].handler(subscribers[i].context, event);
+                stats.deliveries++;
+            }
+        }
+        uint32_t us = profileMicros() - start;
+        stats.dispatchUs += us;
+        if (us > stats.dispatchUsPeak) stats.dispatchUsPeak = us;
+    }
+
+    void beginCycle() { firedMask = 0; }
+    EventMask fired() const { return firedMask; }
+    bool fired(AudioEventType type) const { return firedMask & eventBit(type); }
+
+    int getSubscriberCount() const { return subscriberCount; }
+    const Stats& getStats() const { return stats; }
+
+    uint32_t getPublished() const {
+        uint32_t total = 0;
+        for (uint32_t n : stats.published) total += n;
+        return total;
+    }
+
+private:
+    struct Subscriber {
+        EventMask mask;
+        Handler handler;
+        void* context;
+    };
+
+    Subscriber subscribers[EVENT_BUS_MAX_SUBSCRIBERS];
+    int subscriberCount = 0;
+    EventMask firedMask = 0;
+    Stats stats;
+};
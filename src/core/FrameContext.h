@@ -0,0 +1,78 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include "../config/Config.h"
+#include "../audio/AudioFeatures.h"
+
+// Timing of one LED frame, taken once by the controller and passed to every
+// animation and layer. Everything drawn in a frame sees the same time, and
+// nothing reads the clock per pixel.
+//
+// Per-frame rates (a phase step, a decay factor) scaled by `steps` run at the
+// same speed whatever the frame rate. Layers are stepped by LayerManager at
+// the reference rate already, so only animations need to do this.
+struct FrameContext {
+    uint32_t nowMs = 0;       // millis() at the start of the frame
+    float time = 0.0f;        // nowMs in seconds
+    float dt = 0.0f;          // Seconds since the previous frame, at most FRAME_MAX_DT_MS
+    float steps = 1.0f;       // dt in reference frames of LED_FRAME_INTERVAL_US
+    uint32_t index = 0;       // Frames since boot
+    float speed = 1.0f;       // Global SPEED setting as a multiplier of the layer step rate
+
+    float beatPhase = 0.0f;   // [0, 1) through the current beat
+    uint8_t beat8 = 0;        // beatPhase as 0-255, for sin8() and friends
+    uint32_t beatCount = 0;   // Beats started so far; a layer compares it to see a new beat
+
+    // nowMs / msPerStep cut to 8 bits, the sin8(millis() / k) idiom
+    uint8_t ramp8(uint32_t msPerStep) const { return (uint8_t)(nowMs / msPerStep); }
+
+    // A per-reference-frame decay factor over this frame's dt
+    float decay(float perFrame) const { return steps == 1.0f ? perFrame : powf(perFrame, steps); }
+};
+
+// Builds the FrameContext each frame. The beat phase runs freely at the
+// estimated BPM (FRAME_DEFAULT_BEAT_MS without one) and restarts on each
+// detected beat.
+class FrameClock {
+public:
+    const FrameContext& tick(uint32_t nowMs, uint32_t nowUs, const AudioFeatures& audio, float speed) {
+        uint32_t elapsedUs = started ? nowUs - lastUs : LED_FRAME_INTERVAL_US;
+        if (elapsedUs > FRAME_MAX_DT_MS * 1000UL) elapsedUs = FRAME_MAX_DT_MS * 1000UL;
+        lastUs = nowUs;
+        started = true;
+
+        frame.nowMs = nowMs;
+        frame.time = nowMs * 0.001f;
+        frame.dt = elapsedUs * 1e-6f;
+        frame.steps = (float)elapsedUs / LED_FRAME_INTERVAL_US;
+        frame.index = frames++;
+        frame.speed = speed;
+
+        float beatUs = audio.bpm > 0.0f ? 60e6f / audio.bpm : FRAME_DEFAULT_BEAT_MS * 1000.0f;
+        if (audio.beatDetected && !lastBeatDetected) {
+            beatPhase = 0.0f;
+            frame.beatCount++;
+        } else {
+            beatPhase += elapsedUs / beatUs;
+            if (beatPhase >= 1.0f) {
+                beatPhase -= floorf(beatPhase);
+                frame.beatCount++;
+            }
+        }
+        lastBeatDetected = audio.beatDetected;
+        frame.beatPhase = beatPhase;
+        frame.beat8 = (uint8_t)(beatPhase * 256.0f);
+        return frame;
+    }
+
+    const FrameContext& current() const { return frame; }
+
+private:
+    FrameContext frame;
+    uint32_t frames = 0;
+    uint32_t lastUs = 0;
+    bool started = false;
+    float beatPhase = 0.0f;
+    bool lastBeatDetected = false;
+};
@@ -3,167 +3,589 @@
 #include <FastLED.h>
 #include <functional>
 #include <array>
+#include <utility>
 #include "../audio/AudioFeatures.h"
+#include "../audio/FeatureInterpolator.h"
 #include "../config/Config.h"
+#include "../config/StripConfig.h"
+#include "../core/LedArena.h"
+#include "../core/RenderSettings.h"
+#include "../core/PostProcessor.h"
+#include "../core/PowerLimiter.h"
+#include "../core/FrameContext.h"
+#include "../core/EventBus.h"
+#include "../core/RenderWorkers.h"
+#include "../audio/AudioEvents.h"
 #include "../animations/Animation.h"
 #include "../animations/AnimationCatalog.h"
+#include "../animations/LevelOfDetail.h"
 #include "../scenes/LayerManager.h"
+#include "../scenes/CompiledSceneCatalog.h"
 #include "../audio/AudioHistoryTracker.h"
 #include "../scenes/MoodHistory.h"
 #include "../scenes/SceneRegistry.h"
+#include "../scenes/SceneState.h"
 #include "../scenes/SceneDirector.h"
+#include "../scenes/SceneTransition.h"
+#include "../utils/ProfileClock.h"
 
-#ifdef LED_0_PIN
-CRGB ledStrip_0[LED_0_NUM];
-#endif
-#ifdef LED_1_PIN
-CRGB ledStrip_1[LED_1_NUM];
-#endif
-#ifdef LED_2_PIN
-CRGB ledStrip_2[LED_2_NUM];
-#endif
-#ifdef LED_3_PIN
-CRGB ledStrip_3[LED_3_NUM];
-#endif
-#ifdef LED_4_PIN
-CRGB ledStrip_4[LED_4_NUM];
-#endif
-#ifdef LED_5_PIN
-CRGB ledStrip_5[LED_5_NUM];
-#endif
-#ifdef LED_6_PIN
-CRGB ledStrip_6[LED_6_NUM];
-#endif
-#ifdef LED_7_PIN
-CRGB ledStrip_7[LED_7_NUM];
-#endif
-#ifdef LED_8_PIN
-CRGB ledStrip_8[LED_8_NUM];
-#endif
-#ifdef LED_9_PIN
-CRGB ledStrip_9[LED_9_NUM];
-#endif
+// Register strip I with FastLED; pin, order and chipset are compile-time constants
+template<size_t I>
+void addStripController(CRGB* buffer) {
+    constexpr StripConfig cfg = stripTable[I];
+    CRGB* leds = buffer + stripOffset(I);
+    if constexpr (cfg.chipset == LedChipset::WS2811) FastLED.addLeds<WS2811, cfg.pin, cfg.colorOrder>(leds, cfg.length);
+    else if constexpr (cfg.chipset == LedChipset::WS2812) FastLED.addLeds<WS2812, cfg.pin, cfg.colorOrder>(leds, cfg.length);
+    else if constexpr (cfg.chipset == LedChipset::WS2812B) FastLED.addLeds<WS2812B, cfg.pin, cfg.colorOrder>(leds, cfg.length);
+    else if constexpr (cfg.chipset == LedChipset::WS2813) FastLED.addLeds<WS2813, cfg.pin, cfg.colorOrder>(leds, cfg.length);
+    else if constexpr (cfg.chipset == LedChipset::SK6812) FastLED.addLeds<SK6812, cfg.pin, cfg.colorOrder>(leds, cfg.length);
+}
+
+template<size_t... I>
+void addStripControllers(CRGB* buffer, std::index_sequence<I...>) {
+    (addStripController<I>(buffer), ...);
+}
+
+// Animation and layer stack of one scene, rendering into its own pooled buffer
+struct SceneSlot {
+    const SceneDefinition* scene = nullptr;
+    Animation* animation = nullptr;
+    CompiledScene* compiled = nullptr;  // Instead of animation for compiled scenes
+    LayerManager layers;
+    CRGB* buffer = nullptr;
+    ArenaRegion scratch;
+    uint8_t lodShift = 0;               // Base animation's level of detail on this strip
+    CRGB* lodSamplesBuffer = nullptr;
+
+    ~SceneSlot() { clear(); }
+
+    void clear() {
+        delete animation;
+        animation = nullptr;
+        delete compiled;
+        compiled = nullptr;
+        layers.clearLayers();
+        scratch.releaseScene();
+        scene = nullptr;
+    }
+
+    void load(const SceneDefinition& def, int length, const AudioFeatures& audio, const FrameContext& frame) {
+        clear();
+        scene = &def;
+        lodShift = 0;
+        if (def.compiledScene) {
+            compiled = compiledSceneCatalog[def.compiledScene - 1].create();
+            ScratchAllocator allocator(&scratch, true);
+            compiled->attach(length, allocator);
+        } else {
+            animation = animationFactory(def.baseAnimation)(); // Use the animation factory
+        }
+        if (animation) {
+            ScratchAllocator allocator(&scratch, true);
+            animation->attach(length, allocator);
+            uint8_t maxShift = animation->maxLodShift();
+            lodShift = lodShiftFor(maxShift < LOD_MAX_SHIFT ? maxShift : LOD_MAX_SHIFT, length);
+            lodSamplesBuffer = lodShift ? allocator.allocate<CRGB>(lodSamples(length, lodShift)) : nullptr;
+            if (!lodSamplesBuffer) lodShift = 0;
+        }
+        layers.applySceneLayers(def);
+        drawAnimation(length, audio, frame);
+    }
+
+    void render(int length, const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame) {
+        drawAnimation(length, audio, frame);
+        if (compiled) {
+            compiled->updateLayers(audio, history, frame);
+            compiled->renderLayers(buffer, length);
+        }
+        layers.updateLayers(audio, history, frame);
+        layers.renderLayers();
+    }
+
+    void dispatchEvent(const AudioEvent& event) {
+        if (compiled) compiled->dispatchEvent(event);
+        layers.dispatchEvent(event);
+    }
+
+    // At a reduced level of detail the animation writes samples, spread over the buffer here
+    void drawAnimation(int length, const AudioFeatures& audio, const FrameContext& frame) {
+        if (compiled) {
+            compiled->drawAnimation(buffer, length, audio, frame);
+            return;
+        }
+        if (!animation) return;
+        if (lodShift == 0) {
+            animation->update(buffer, length, audio, frame);
+            return;
+        }
+        animation->updateSampled(lodSamplesBuffer, lodSamples(length, lodShift), length, 1 << lodShift, audio, frame);
+        lodUpsampleCopy(lodSamplesBuffer, lodShift, buffer, length);
+    }
+};
 
 class LEDStrip {
 public:
+    // Arena memory handed out by LEDStripController::begin()
+    struct Buffers {
+        CRGB* scene[2];
+        CRGB* composite;
+        CRGB* output;
+        void* scratch[3];
+        size_t scratchBytes;
+    };
+
     int index = -1;
     int length = 0;
-    CRGB* leds = nullptr;
-    Animation* currentAnimation = nullptr;
-    LayerManager layerManager;
+    CRGB* leds = nullptr;      // Composed frame the post-process pass reads
+    CRGB* output = nullptr;    // Post-processed copy registered with FastLED
+    const SceneDefinition* activeScene = nullptr;
 
-    ~LEDStrip() {
-        if (currentAnimation) delete currentAnimation;
-        layerManager.clearLayers();
+    void init(int len, const Buffers& buffers) {
+        length = len;
+        output = buffers.output;
+        composite = buffers.composite;
+        for (int i = 0; i < 2; ++i) {
+            slots[i].buffer = buffers.scene[i];
+            slots[i].scratch.init(buffers.scratch[i], buffers.scratchBytes);
+            slots[i].layers.setLEDs(slots[i].buffer, length);
+            slots[i].layers.setScratch(&slots[i].scratch);
+        }
+        overlayScratch.init(buffers.scratch[2], buffers.scratchBytes);
+        overlayLayers.setScratch(&overlayScratch);
+        leds = slots[current].buffer;
+        overlayLayers.setLEDs(leds, length);
     }
 
-    void init(int len, CRGB* buffer) {
-        length = len;
-        leds = buffer;
-        layerManager.setLEDs(leds, length);
+    // Load a new scene into the idle slot and fade over to it. A transition already
+    // in progress is cut short: its outgoing scene is the one replaced.
+    void applyScene(const SceneDefinition& scene, const AudioFeatures& audio, const FrameContext& frame, TransitionStats& stats) {
+        if (activeScene == &scene) return;
+        activeScene = &scene;
+
+        if (!slots[current].scene || SCENE_TRANSITION_MS == 0) {
+            slots[current].load(scene, length, audio, frame);
+            return;
+        }
+
+        current ^= 1;
+        slots[current].load(scene, length, audio, frame);
+        transitioning = true;
+        outgoingFrozen = false;
+        transitionStart = frame.nowMs;
+        transitionStyle = static_cast<TransitionStyle>(random(static_cast<int>(TransitionStyle::COUNT)));
+        transitionSeed = random(256);
+        stats.transitions++;
+    }
+
+    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame, TransitionStats& stats) {
+        SceneSlot& incoming = slots[current];
+        incoming.render(length, audio, history, frame);
+        leds = incoming.buffer;
+
+        if (transitioning) {
+            unsigned long elapsed = frame.nowMs - transitionStart;
+            if (elapsed >= SCENE_TRANSITION_MS) {
+                slots[current ^ 1].clear();
+                transitioning = false;
+            } else {
+                // Everything below is the added cost of a transition frame
+                uint32_t extraStart = profileMicros();
+                SceneSlot& outgoing = slots[current ^ 1];
+                if (!outgoingFrozen) outgoing.render(length, audio, history, frame);
+                uint8_t progress = (uint8_t)(elapsed * 255 / SCENE_TRANSITION_MS);
+                blendTransition(transitionStyle, outgoing.buffer, incoming.buffer, composite, length, progress, transitionSeed);
+                leds = composite;
+
+                uint32_t extraUs = profileMicros() - extraStart;
+                stats.record(extraUs);
+                // Over budget: keep blending against the outgoing scene's last frame
+                if (!outgoingFrozen && transitionFreezeUs > 0 && extraUs > transitionFreezeUs) {
+                    outgoingFrozen = true;
+                    stats.frozenTransitions++;
+                }
+            }
+        }
+
+        overlayLayers.setLEDs(leds, length);
+        overlayLayers.updateLayers(audio, history, frame);
+        overlayLayers.renderLayers();
     }
 
-    void setAnimation(AnimationType type, const AudioFeatures& audio) {
-        if (currentAnimation) delete currentAnimation;
-        currentAnimation = animationFactory(type)(); // Use the animation factory
-        if (currentAnimation) currentAnimation->update(leds, length, audio);
+    bool isTransitioning() const { return transitioning; }
+
+    // Scene slots and the overlay stack all spawn from the same pool
+    void setLayerPool(LayerPool* pool) {
+        for (SceneSlot& slot : slots) slot.layers.setLayerPool(pool);
+        overlayLayers.setLayerPool(pool);
+    }
+
+    uint32_t getBudgetRejections() const {
+        return slots[0].layers.getBudgetRejections() + slots[1].layers.getBudgetRejections()
+             + overlayLayers.getBudgetRejections();
     }
 
-    void update(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history) {
-        if (currentAnimation && leds)
-            currentAnimation->update(leds, length, audio);
-        layerManager.updateLayers(audio, history);
-        layerManager.renderLayers(); // Remove extra arguments if not needed
+    uint32_t getSkippedRenders() const {
+        return slots[0].layers.getSkippedRenders() + slots[1].layers.getSkippedRenders()
+             + overlayLayers.getSkippedRenders();
     }
 
-    LayerManager& getLayerManager() { return layerManager; }
+    uint32_t getFusedRenders() const {
+        return slots[0].layers.getFusedRenders() + slots[1].layers.getFusedRenders()
+             + overlayLayers.getFusedRenders();
+    }
+
+    uint32_t getDormantSkips() const {
+        return slots[0].layers.getDormantSkips() + slots[1].layers.getDormantSkips()
+             + overlayLayers.getDormantSkips();
+    }
+
+    // EventBus handler: both scene slots, so a fading-out scene keeps reacting, and the overlays
+    static void onEvent(void* strip, const AudioEvent& event) {
+        LEDStrip& self = *static_cast<LEDStrip*>(strip);
+        for (SceneSlot& slot : self.slots) slot.dispatchEvent(event);
+        self.overlayLayers.dispatchEvent(event);
+    }
+
+    void addCacheStats(std::vector<LayerCacheStats>& out) const {
+        const LayerManager* managers[3] = { &slots[0].layers, &slots[1].layers, &overlayLayers };
+        for (const LayerManager* manager : managers) {
+            for (const LayerCacheStats& stats : manager->getCacheStats()) {
+                auto it = std::find_if(out.begin(), out.end(), [&](const LayerCacheStats& o) {
+                    return !strcmp(o.name, stats.name);
+                });
+                if (it == out.end()) {
+                    out.push_back(stats);
+                } else {
+                    it->hits += stats.hits;
+                    it->misses += stats.misses;
+                }
+            }
+        }
+    }
+
+    void setRenderBudget(uint32_t us) {
+        for (SceneSlot& slot : slots) slot.layers.setRenderBudget(us);
+        overlayLayers.setRenderBudget(us);
+    }
+
+    void setFusedRendering(bool enabled) {
+        for (SceneSlot& slot : slots) slot.layers.setFusedRendering(enabled);
+        overlayLayers.setFusedRendering(enabled);
+    }
+
+    // Extra transition frame time before the outgoing scene is frozen; 0 never freezes
+    void setTransitionFreezeBudget(uint32_t us) {
+        transitionFreezeUs = us;
+    }
+
+    void addGovernorStats(GovernorStats& stats) const {
+        stats.add(slots[0].layers.getGovernorStats());
+        stats.add(slots[1].layers.getGovernorStats());
+        stats.add(overlayLayers.getGovernorStats());
+    }
+
+    // Layers added here outlive scene changes and draw on top of the composed frame
+    LayerManager& getLayerManager() { return overlayLayers; }
+    LayerManager& getSceneLayers() { return slots[current].layers; }
+
+    void addScratchUsage(size_t& capacity, size_t& used, size_t& peak, size_t& failed) const {
+        const ArenaRegion* regions[3] = { &slots[0].scratch, &slots[1].scratch, &overlayScratch };
+        for (const ArenaRegion* r : regions) {
+            capacity += r->capacity();
+            used += r->used();
+            peak += r->peakUsed();
+            failed += r->failedAllocations();
+        }
+    }
+
+private:
+    SceneSlot slots[2];
+    int current = 0;
+    CRGB* composite = nullptr;
+    LayerManager overlayLayers;
+    ArenaRegion overlayScratch;
+
+    bool transitioning = false;
+    bool outgoingFrozen = false;
+    uint32_t transitionFreezeUs = TRANSITION_MAX_EXTRA_US;
+    unsigned long transitionStart = 0;
+    TransitionStyle transitionStyle = TransitionStyle::CROSSFADE;
+    uint8_t transitionSeed = 0;
 };
 
 class LEDStripController {
 private:
-    AudioFeatures& audio;
+    AudioFeatures& audio;          // Latest analysis result, written by the audio side
+    AudioFeatures frameAudio;      // Interpolated features the strips render with
+    FeatureInterpolator interpolator;
+    FrameClock frameClock;
+    EventBus eventBus;
+    AudioEventDetector eventDetector;
+    MoodType lastMood = UNKNOWN;
+    const SceneDefinition* lastScene = nullptr;
+    uint32_t lastAnalysisTimestamp = 0;
     MoodHistory& moodHistory;
     AudioHistoryTracker& audioHistory;
     SceneRegistry sceneRegistry;
+    SceneState sceneState;
     SceneDirector sceneDirector;
-    LEDStrip strips[10];
+    LedArena arena;
+    RenderSettings renderSettings;
+    PostProcessor postProcessor;
+    PowerLimiter powerLimiter;
+    LayerPool layerPool;
+    LEDStrip strips[stripTableSize];
     int stripCount = 0;
+    bool sceneTableLoaded = false;
+
+    // Strips render as one batch on the render lanes, then their post-processing
+    // as a second batch of chunks. Each strip keeps its own transition stats so
+    // lanes share nothing but the layer pool.
+    struct OutputChunk {
+        uint8_t strip;
+        uint16_t first;
+        uint16_t count;
+    };
+    RenderWorkers renderWorkers;
+    TransitionStats stripTransitions[stripTableSize];
+    uint32_t stripCostUs[stripTableSize] = {};     // Smoothed render time, the balancing prediction
+    uint32_t stripMeasuredUs[stripTableSize] = {};
+    OutputChunk outputChunks[RENDER_MAX_JOBS];
+    uint32_t chunkCostUs[RENDER_MAX_JOBS] = {};
+    uint32_t chunkMeasuredUs[RENDER_MAX_JOBS] = {};
+    ChannelSums chunkSums[RENDER_MAX_JOBS];
+    int outputChunkCount = 0;
+
+    static constexpr size_t framebufferCount = 4;
+    static_assert(stripTableSize < RENDER_MAX_JOBS, "every strip needs at least one render job");
+    static_assert(stripTableSize <= EVENT_BUS_MAX_SUBSCRIBERS, "every strip subscribes to the EventBus");
 
 public:
 LEDStripController(AudioFeatures& af, MoodHistory& mh, AudioHistoryTracker& ah)
-  : audio(audio), moodHistory(moodHistory), audioHistory(audioHistory), sceneDirector(moodHistory, sceneRegistry) {}
+  : audio(af), moodHistory(mh), audioHistory(ah), sceneDirector(mh, sceneRegistry) {}
 
-    void begin() {
-        sceneRegistry.registerDefaultScenes();
+    // sceneFile is a compiled scene table; the built-in scenes are used without one
+    void begin(const char* sceneFile = SCENE_FILE_PATH) {
+        sceneTableLoaded = sceneFile && sceneRegistry.loadTable(sceneFile);
+        if (!sceneTableLoaded) {
+            sceneRegistry.registerDefaultScenes();
+        }
+        sceneDirector.attachState(&sceneState);
         sceneDirector.begin();
+        // The pool is shared by every strip, so it grows with the strip table
+        size_t poolSlots = stripTableSize * LAYER_POOL_SLOTS_PER_STRIP;
+        if (poolSlots > LayerPool::maxSlotsPerClass) {
+            Serial.printf("Layer pool: %u slots per class needed, capped at %u\n",
+                          (unsigned)poolSlots, (unsigned)LayerPool::maxSlotsPerClass);
+            poolSlots = LayerPool::maxSlotsPerClass;
+        }
+        layerPool.registerCatalog((uint8_t)poolSlots);
 
-        #ifdef LED_0_PIN
-        FastLED.addLeds<WS2812B, LED_0_PIN, GRB>(ledStrip_0, LED_0_NUM);
-        strips[stripCount].init(LED_0_NUM, ledStrip_0);
-        ++stripCount;
-        #endif
-        #ifdef LED_1_PIN
-        FastLED.addLeds<WS2812B, LED_1_PIN, GRB>(ledStrip_1, LED_1_NUM);
-        strips[stripCount].init(LED_1_NUM, ledStrip_1);
-        ++stripCount;
-        #endif
-        #ifdef LED_2_PIN
-        FastLED.addLeds<WS2812B, LED_2_PIN, GRB>(ledStrip_2, LED_2_NUM);
-        strips[stripCount].init(LED_2_NUM, ledStrip_2);
-        ++stripCount;
-        #endif
-        #ifdef LED_3_PIN
-        FastLED.addLeds<WS2812B, LED_3_PIN, GRB>(ledStrip_3, LED_3_NUM);
-        strips[stripCount].init(LED_3_NUM, ledStrip_3);
-        ++stripCount;
-        #endif
-        #ifdef LED_4_PIN
-        FastLED.addLeds<WS2812B, LED_4_PIN, GRB>(ledStrip_4, LED_4_NUM);
-        strips[stripCount].init(LED_4_NUM, ledStrip_4);
-        ++stripCount;
-        #endif
-        #ifdef LED_5_PIN
-        FastLED.addLeds<WS2812B, LED_5_PIN, GRB>(ledStrip_5, LED_5_NUM);
-        strips[stripCount].init(LED_5_NUM, ledStrip_5);
-        ++stripCount;
-        #endif
-        #ifdef LED_6_PIN
-        FastLED.addLeds<WS2812B, LED_6_PIN, GRB>(ledStrip_6, LED_6_NUM);
-        strips[stripCount].init(LED_6_NUM, ledStrip_6);
-        ++stripCount;
-        #endif
-        #ifdef LED_7_PIN
-        FastLED.addLeds<WS2812B, LED_7_PIN, GRB>(ledStrip_7, LED_7_NUM);
-        strips[stripCount].init(LED_7_NUM, ledStrip_7);
-        ++stripCount;
-        #endif
-        #ifdef LED_8_PIN
-        FastLED.addLeds<WS2812B, LED_8_PIN, GRB>(ledStrip_8, LED_8_NUM);
-        strips[stripCount].init(LED_8_NUM, ledStrip_8);
-        ++stripCount;
-        #endif
-        #ifdef LED_9_PIN
-        FastLED.addLeds<WS2812B, LED_9_PIN, GRB>(ledStrip_9, LED_9_NUM);
-        strips[stripCount].init(LED_9_NUM, ledStrip_9);
-        ++stripCount;
-        #endif
-
-        FastLED.setBrightness(DEFAULT_BRIGHTNESS);
+        // Framebuffers first (two scene slots, composite, output), each set back to
+        // back in stripTable order; then three scratch regions per strip (one per
+        // scene slot, one for persistent overlay layers)
+        size_t scratchBytes[stripTableSize];
+        size_t arenaBytes = framebufferCount * LedArena::alignUp(totalLedCount * sizeof(CRGB));
+        for (size_t i = 0; i < stripTableSize; ++i) {
+            scratchBytes[i] = LedArena::alignUp((size_t)stripTable[i].length * LAYER_SCRATCH_BYTES_PER_LED);
+            arenaBytes += 3 * scratchBytes[i];
+        }
+        if (!arena.begin(arenaBytes, LED_ARENA_USE_PSRAM)) {
+            Serial.printf("LED arena: cannot allocate %u bytes\n", (unsigned)arenaBytes);
+            return;
+        }
+
+        CRGB* frames[framebufferCount];
+        for (CRGB*& frame : frames) frame = static_cast<CRGB*>(arena.reserve(totalLedCount * sizeof(CRGB)));
+        addStripControllers(frames[3], std::make_index_sequence<stripTableSize>{});
+        for (size_t i = 0; i < stripTableSize; ++i) {
+            LEDStrip::Buffers buffers;
+            buffers.scene[0] = frames[0] + stripOffset(i);
+            buffers.scene[1] = frames[1] + stripOffset(i);
+            buffers.composite = frames[2] + stripOffset(i);
+            buffers.output = frames[3] + stripOffset(i);
+            for (void*& region : buffers.scratch) region = arena.reserve(scratchBytes[i]);
+            buffers.scratchBytes = scratchBytes[i];
+            strips[i].index = i;
+            strips[i].init(stripTable[i].length, buffers);
+            strips[i].setLayerPool(&layerPool);
+            if (!eventBus.subscribe(0xFF, &LEDStrip::onEvent, &strips[i])) {
+                Serial.printf("EventBus: strip %u not subscribed, it won't see audio events\n", (unsigned)i);
+            }
+        }
+        stripCount = stripTableSize;
+        planOutputChunks();
+        if (!renderWorkers.begin(RENDER_WORKERS)) {
+            Serial.printf("Render lanes: %d of %d started\n", renderWorkers.getLanes(), RENDER_WORKERS);
+        }
+
+        // Brightness is applied by the post-process pass, together with gamma
+        FastLED.setBrightness(255);
         FastLED.show();
     }
 
-    void update() {
-        audioHistory.addSnapshot(audio);
-        moodHistory.update(audio);
-        sceneDirector.update(audio);
+    // Hue, saturation and brightness go to the post-process tables, speed to the layers
+    void setRenderSettings(const RenderSettings& settings) {
+        if (settings == renderSettings) return;
+        renderSettings = settings;
+        postProcessor.configure(renderSettings);
+    }
 
+    const PowerLimiter& getPowerLimiter() const {
+        return powerLimiter;
+    }
+
+    // Counts summed, last and peak the worst strip's, and the mean each strip's
+    // weighted by the transitions it ran
+    TransitionStats getTransitionStats() const {
+        TransitionStats total;
+        float weightedMeanUs = 0.0f;
         for (int i = 0; i < stripCount; ++i) {
-            const SceneDefinition* scene = &sceneDirector.getCurrentScene().getActiveScene();
-            if (scene) {
-                strips[i].setAnimation(scene->baseAnimation, audio);
-                strips[i].getLayerManager().applySceneLayers(*scene);
+            const TransitionStats& s = stripTransitions[i];
+            total.transitions += s.transitions;
+            total.frozenTransitions += s.frozenTransitions;
+            if (s.lastExtraUs > total.lastExtraUs) total.lastExtraUs = s.lastExtraUs;
+            if (s.peakExtraUs > total.peakExtraUs) total.peakExtraUs = s.peakExtraUs;
+            weightedMeanUs += s.meanExtraUs * s.transitions;
+        }
+        total.meanExtraUs = total.transitions ? weightedMeanUs / total.transitions : 0.0f;
+        return total;
+    }
+
+    // Lanes rendering the strips (RENDER_WORKERS by default). The sim uses one
+    // so its output doesn't depend on which strip draws from random() first.
+    bool setRenderWorkers(int lanes) {
+        return renderWorkers.begin(lanes);
+    }
+
+    const RenderWorkers& getRenderWorkers() const {
+        return renderWorkers;
+    }
+
+    const LayerPool& getLayerPool() const {
+        return layerPool;
+    }
+
+    uint32_t getBudgetRejections() const {
+        uint32_t total = 0;
+        for (int i = 0; i < stripCount; ++i) total += strips[i].getBudgetRejections();
+        return total;
+    }
+
+    // Layer renders skipped because the layer reported nothing to draw
+    uint32_t getSkippedRenders() const {
+        uint32_t total = 0;
+        for (int i = 0; i < stripCount; ++i) total += strips[i].getSkippedRenders();
+        return total;
+    }
+
+    // Layer frames skipped because the layer was dormant, waiting for an event
+    uint32_t getDormantSkips() const {
+        uint32_t total = 0;
+        for (int i = 0; i < stripCount; ++i) total += strips[i].getDormantSkips();
+        return total;
+    }
+
+    EventBus& getEventBus() {
+        return eventBus;
+    }
+
+    const EventBus& getEventBus() const {
+        return eventBus;
+    }
+
+    // Layer renders drawn chunk by chunk as part of a fused run
+    uint32_t getFusedRenders() const {
+        uint32_t total = 0;
+        for (int i = 0; i < stripCount; ++i) total += strips[i].getFusedRenders();
+        return total;
+    }
+
+    // Output cache hits per layer class, over every strip and stack
+    std::vector<LayerCacheStats> getCacheStats() const {
+        std::vector<LayerCacheStats> stats;
+        for (int i = 0; i < stripCount; ++i) strips[i].addCacheStats(stats);
+        return stats;
+    }
+
+    // Per-stack layer time budget for the quality governor (LAYER_RENDER_BUDGET_US by default)
+    void setLayerRenderBudget(uint32_t us) {
+        for (int i = 0; i < stripCount; ++i) strips[i].setRenderBudget(us);
+    }
+
+    // Measured on the host the freeze depends on its speed, so the simulator can pin it off
+    void setTransitionFreezeBudget(uint32_t us) {
+        for (int i = 0; i < stripCount; ++i) strips[i].setTransitionFreezeBudget(us);
+    }
+
+    // Chunked evaluation of fusable layer runs (LAYER_FUSED_RENDERING by default)
+    void setFusedRendering(bool enabled) {
+        for (int i = 0; i < stripCount; ++i) strips[i].setFusedRendering(enabled);
+    }
+
+    GovernorStats getGovernorStats() const {
+        GovernorStats stats;
+        for (int i = 0; i < stripCount; ++i) strips[i].addGovernorStats(stats);
+        return stats;
+    }
+
+    const RenderSettings& getRenderSettings() const {
+        return renderSettings;
+    }
+
+    // True when the scenes came from the scene file rather than the built-in list
+    bool hasSceneTable() const {
+        return sceneTableLoaded;
+    }
+
+    const SceneRegistry& getSceneRegistry() const {
+        return sceneRegistry;
+    }
+
+    void update() {
+        // History, moods and scene changes move at the analysis rate; rendering
+        // samples the interpolator at the LED frame rate
+        if (audio.timestamp != lastAnalysisTimestamp || !interpolator.ready()) {
+            lastAnalysisTimestamp = audio.timestamp;
+            audioHistory.addSnapshot(audio);
+            eventBus.beginCycle();
+            eventDetector.process(audio, millis(), [this](const AudioEvent& e) { eventBus.publish(e); });
+            sceneDirector.update(audio); // also feeds moodHistory
+            publishShowEvents();
+            interpolator.push(audio, audio.timestamp);
+            for (int i = 0; i < stripCount; ++i) {
+                sceneDirector.maybeInjectReactiveLayer(strips[i].getSceneLayers(), audio, eventBus.fired(), millis());
             }
-            strips[i].update(audio, audioHistory.getHistory());
+        }
+        interpolator.sample(micros() + FEATURE_SHOW_LEAD_US, frameAudio);
+        // One clock reading for everything drawn this frame
+        const FrameContext& frame = frameClock.tick(millis(), micros(), frameAudio, renderSettings.speed / 100.0f);
+
+        // Scene loads draw from random() and construct layers, so they stay on
+        // this task; the frame itself renders on every lane
+        const SceneDefinition* scene = sceneDirector.getActiveScene();
+        if (scene) {
+            for (int i = 0; i < stripCount; ++i) strips[i].applyScene(*scene, frameAudio, frame, stripTransitions[i]);
+        }
+        renderWorkers.run(&LEDStripController::renderStripJob, this, stripCount, stripCostUs, stripMeasuredUs);
+        smoothCosts(stripCostUs, stripMeasuredUs, stripCount);
+        renderWorkers.run(&LEDStripController::outputChunkJob, this, outputChunkCount, chunkCostUs, chunkMeasuredUs);
+        smoothCosts(chunkCostUs, chunkMeasuredUs, outputChunkCount);
+
+        // The barrier is behind us: every strip's output is complete
+        ChannelSums stripSums[stripTableSize];
+        for (int j = 0; j < outputChunkCount; ++j) {
+            ChannelSums& sums = stripSums[outputChunks[j].strip];
+            sums.r += chunkSums[j].r;
+            sums.g += chunkSums[j].g;
+            sums.b += chunkSums[j].b;
+        }
+        for (int i = 0; i < stripCount; ++i) powerLimiter.setDemand(i, stripSums[i], strips[i].length);
+        postProcessor.nextFrame();
+
+        powerLimiter.resolve(stripCount);
+        for (int i = 0; i < stripCount; ++i) {
+            powerLimiter.apply(i, strips[i].output, strips[i].length);
         }
 
         static unsigned long lastDebugPrint = 0;
@@ -177,6 +599,43 @@ LEDStripController(AudioFeatures& af, MoodHistory& mh, AudioHistoryTracker& ah)
             Serial.println(sceneDirector.getCurrentSceneName());
             Serial.print(F("Mood: "));
             Serial.println(moodHistory.getCurrentMoodName());
+            ArenaUsage usage = getArenaUsage();
+            Serial.printf("LED arena: %u/%u scratch bytes used (peak %u), %u B framebuffers, %s%s\n",
+                          (unsigned)usage.scratchUsed, (unsigned)usage.scratchCapacity, (unsigned)usage.scratchPeak,
+                          (unsigned)usage.framebufferBytes, usage.psram ? "PSRAM" : "internal RAM",
+                          usage.failedAllocations ? ", allocations failed" : "");
+            Serial.printf("Power: %.2f W (%u mA), %d strip(s) limited\n",
+                          powerLimiter.getWatts(), (unsigned)powerLimiter.getTotalMilliamps(),
+                          powerLimiter.getLimitedStripCount());
+            const LayerPool::Stats& pool = layerPool.getStats();
+            Serial.printf("Layers: %u/%u pool slots in use, %u spawned (%u recycled), %u refused by budget, %u by full pool, "
+                          "%u renders skipped, %u fused, %u dormant\n",
+                          (unsigned)pool.inUse, (unsigned)pool.slots, (unsigned)pool.spawned, (unsigned)pool.recycled,
+                          (unsigned)getBudgetRejections(), (unsigned)pool.exhausted, (unsigned)getSkippedRenders(),
+                          (unsigned)getFusedRenders(), (unsigned)getDormantSkips());
+            GovernorStats governor = getGovernorStats();
+            Serial.printf("Layer time: %.0f us/frame (peak %.0f), %u coarsened, %u decimated, %u suspended, %u degrades, %u restores",
+                          governor.stackUs, governor.peakStackUs, (unsigned)governor.coarsenedNow, (unsigned)governor.decimatedNow,
+                          (unsigned)governor.suspendedNow, (unsigned)governor.degrades, (unsigned)governor.restores);
+            if (governor.lastLayer) {
+                Serial.printf(", last: %s -> %s 1/%d", governor.lastLayer, layerQualityToString(governor.lastQuality),
+                              1 << governor.lastLodShift);
+            }
+            Serial.println();
+            std::vector<LayerCacheStats> cache = getCacheStats();
+            if (!cache.empty()) {
+                Serial.print(F("Layer cache hits:"));
+                for (const LayerCacheStats& stats : cache) Serial.printf(" %s %.0f%%", stats.name, stats.hitRate() * 100.0f);
+                Serial.println();
+            }
+            TransitionStats transitions = getTransitionStats();
+            Serial.printf("Transitions: %u (%u frozen), extra frame time mean %.0f us, peak %u us\n",
+                          (unsigned)transitions.transitions, (unsigned)transitions.frozenTransitions,
+                          transitions.meanExtraUs, (unsigned)transitions.peakExtraUs);
+            const RenderWorkers::Stats& lanes = renderWorkers.getStats();
+            Serial.printf("Render lanes: %d, scaling efficiency %.0f%%, last batch %u us of work in %u us, %u steals\n",
+                          renderWorkers.getLanes(), lanes.efficiency * 100.0f, (unsigned)lanes.lastWorkUs,
+                          (unsigned)lanes.lastWallUs, (unsigned)lanes.steals);
 
         }
         FastLED.show();
@@ -189,4 +648,92 @@ LEDStripController(AudioFeatures& af, MoodHistory& mh, AudioHistoryTracker& ah)
     int getStripCount() const {
         return stripCount;
     }
+
+    LEDStrip& getStrip(int index) {
+        return strips[index];
+    }
+
+    struct ArenaUsage {
+        size_t capacity = 0;
+        size_t framebufferBytes = 0;
+        size_t scratchCapacity = 0;
+        size_t scratchUsed = 0;
+        size_t scratchPeak = 0;
+        size_t failedAllocations = 0;
+        bool psram = false;
+    };
+
+    ArenaUsage getArenaUsage() const {
+        ArenaUsage usage;
+        usage.capacity = arena.capacity();
+        usage.framebufferBytes = framebufferCount * LedArena::alignUp(totalLedCount * sizeof(CRGB));
+        usage.psram = arena.inPsram();
+        for (int i = 0; i < stripCount; ++i) {
+            strips[i].addScratchUsage(usage.scratchCapacity, usage.scratchUsed, usage.scratchPeak, usage.failedAllocations);
+        }
+        return usage;
+    }
+
+private:
+    static void renderStripJob(void* context, int i) {
+        LEDStripController& self = *static_cast<LEDStripController*>(context);
+        self.strips[i].update(self.frameAudio, self.audioHistory.getHistory(), self.frameClock.current(),
+                              self.stripTransitions[i]);
+    }
+
+    static void outputChunkJob(void* context, int j) {
+        LEDStripController& self = *static_cast<LEDStripController*>(context);
+        const OutputChunk& chunk = self.outputChunks[j];
+        const LEDStrip& strip = self.strips[chunk.strip];
+        self.chunkSums[j] = self.postProcessor.apply(strip.leds + chunk.first, strip.output + chunk.first,
+                                                     chunk.count, chunk.first);
+    }
+
+    // Next frame's prediction of each job, from what it took this frame
+    static void smoothCosts(uint32_t* predictedUs, const uint32_t* measuredUs, int count) {
+        for (int j = 0; j < count; ++j) {
+            predictedUs[j] = predictedUs[j] ? (predictedUs[j] * 3 + measuredUs[j]) / 4 : measuredUs[j];
+        }
+    }
+
+    // Cut every strip into post-processing chunks of about RENDER_CHUNK_PIXELS,
+    // larger if that would make more than RENDER_MAX_JOBS
+    void planOutputChunks() {
+        int chunkPixels = RENDER_CHUNK_PIXELS;
+        int spare = RENDER_MAX_JOBS - stripCount;
+        if ((int)totalLedCount > chunkPixels * spare) chunkPixels = ((int)totalLedCount + spare - 1) / spare;
+        outputChunkCount = 0;
+        for (int i = 0; i < stripCount; ++i) {
+            int length = strips[i].length;
+            int pieces = length > chunkPixels ? (length + chunkPixels - 1) / chunkPixels : 1;
+            for (int p = 0; p < pieces; ++p) {
+                OutputChunk& chunk = outputChunks[outputChunkCount];
+                chunk.strip = (uint8_t)i;
+                chunk.first = (uint16_t)(length * p / pieces);
+                chunk.count = (uint16_t)(length * (p + 1) / pieces - chunk.first);
+                outputChunkCount++;
+            }
+        }
+    }
+
+    // Mood and scene changes, once the director has seen this analysis result
+    void publishShowEvents() {
+        AudioEvent e;
+        e.timeMs = millis();
+        e.bpm = audio.bpm;
+        MoodType mood = moodHistory.getCurrentMood();
+        if (mood != lastMood) {
+            lastMood = mood;
+            e.type = AudioEventType::MOOD_CHANGE;
+            e.value = (float)mood;
+            eventBus.publish(e);
+        }
+        const SceneDefinition* scene = sceneDirector.getActiveScene();
+        if (scene != lastScene) {
+            lastScene = scene;
+            e.type = AudioEventType::SCENE_CHANGE;
+            e.value = 0.0f;
+            eventBus.publish(e);
+        }
+    }
 };
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#ifndef NATIVE_BUILD
+#include <esp_heap_caps.h>
+#endif
+
+// ==== LED memory arena ====
+// One aligned block, allocated once at startup, that holds every strip framebuffer
+// followed by one scratch region per strip. Layers and animations take their
+// working buffers from their strip's region instead of the heap or the stack, so
+// nothing is allocated per frame and nothing is shared between instances.
+
+class LedArena {
+public:
+    // Cache line size on the ESP32 PSRAM cache; also keeps float/CRGB arrays word aligned
+    static constexpr size_t alignment = 32;
+
+    static constexpr size_t alignUp(size_t bytes) {
+        return (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    ~LedArena() { end(); }
+
+    bool begin(size_t bytes, bool preferPsram) {
+        end();
+        bytes = alignUp(bytes);
+#ifdef NATIVE_BUILD
+        (void)preferPsram;
+        block = static_cast<uint8_t*>(aligned_alloc(alignment, bytes));
+#else
+        if (preferPsram) {
+            block = static_cast<uint8_t*>(heap_caps_aligned_alloc(alignment, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+            psram = block != nullptr;
+        }
+        if (!block) {
+            block = static_cast<uint8_t*>(heap_caps_aligned_alloc(alignment, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        }
+#endif
+        if (!block) return false;
+        memset(block, 0, bytes);
+        size = bytes;
+        offset = 0;
+        return true;
+    }
+
+    void end() {
+#ifdef NATIVE_BUILD
+        free(block);
+#else
+        if (block) heap_caps_free(block);
+#endif
+        block = nullptr;
+        size = offset = 0;
+        psram = false;
+    }
+
+    // Bump allocation for the lifetime of the arena; nullptr when the block is full
+    void* reserve(size_t bytes) {
+        bytes = alignUp(bytes);
+        if (!block || offset + bytes > size) return nullptr;
+        void* p = block + offset;
+        offset += bytes;
+        return p;
+    }
+
+    size_t capacity() const { return size; }
+    size_t reserved() const { return offset; }
+    bool inPsram() const { return psram; }
+
+private:
+    uint8_t* block = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    bool psram = false;
+};
+
+// A strip's slice of the arena. Persistent allocations grow up from the bottom and
+// live as long as the strip; scene allocations grow down from the top and are all
+// released at once when the strip switches scene. An owner that comes and goes
+// within a scene (a spawned layer) can hand its block back earlier.
+class ArenaRegion {
+public:
+    void init(void* memory, size_t bytes) {
+        base = static_cast<uint8_t*>(memory);
+        size = memory ? bytes : 0;
+        bottom = 0;
+        top = size;
+        peak = 0;
+        failures = 0;
+        freedCount = 0;
+    }
+
+    void* take(size_t bytes, bool sceneScoped) {
+        bytes = LedArena::alignUp(bytes);
+        if (!base || bytes > top - bottom) {
+            failures++;
+            return nullptr;
+        }
+        uint8_t* p;
+        if (sceneScoped) {
+            top -= bytes;
+            p = base + top;
+        } else {
+            p = base + bottom;
+            bottom += bytes;
+        }
+        memset(p, 0, bytes);
+        if (used() > peak) peak = used();
+        return p;
+    }
+
+    void releaseScene() {
+        top = size;
+        freedCount = 0;
+    }
+
+    // Offset of the lowest scene allocation. Read before and after an owner's
+    // allocations, it brackets the owner's block for releaseSceneBlock().
+    size_t sceneMark() const { return top; }
+
+    // Hands back the scene block [from, to) before the scene ends. A block at
+    // the top of the scene stack is popped at once, along with any freed blocks
+    // it was holding in place; others wait in a short list. If the list is
+    // full the block stays taken until releaseScene().
+    void releaseSceneBlock(size_t from, size_t to) {
+        if (from >= to || from < top || to > size) return;
+        if (from != top) {
+            if (freedCount < maxFreedBlocks) freed[freedCount++] = { from, to };
+            return;
+        }
+        top = to;
+        for (int i = 0; i < freedCount;) {
+            if (freed[i].from == top) {
+                top = freed[i].to;
+                freed[i] = freed[--freedCount];
+                i = 0;
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    size_t capacity() const { return size; }
+    size_t used() const { return bottom + (size - top); }
+    size_t peakUsed() const { return peak; }
+    size_t failedAllocations() const { return failures; }
+
+private:
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    size_t bottom = 0;
+    size_t top = 0;
+    size_t peak = 0;
+    size_t failures = 0;
+
+    static constexpr int maxFreedBlocks = 8;
+    struct Block {
+        size_t from;
+        size_t to;
+    };
+    Block freed[maxFreedBlocks];
+    int freedCount = 0;
+};
+
+// What a layer or animation sees in attach(): typed, zero-initialised buffers from
+// its strip's region. Returns nullptr when the region is exhausted or absent.
+class ScratchAllocator {
+public:
+    ScratchAllocator(ArenaRegion* region = nullptr, bool sceneScoped = true)
+        : region(region), sceneScoped(sceneScoped) {}
+
+    template<typename T>
+    T* allocate(size_t count) {
+        if (!region || count == 0) return nullptr;
+        return static_cast<T*>(region->take(count * sizeof(T), sceneScoped));
+    }
+
+private:
+    ArenaRegion* region;
+    bool sceneScoped;
+};
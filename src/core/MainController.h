@@ -5,6 +5,7 @@
 #include <TFT_eSPI.h>
 #include "../audio/AudioProcessor.h"
 #include "../audio/AudioHistoryTracker.h"
+#include "../audio/FeatureRecorder.h"
 #include "../input/EncoderInput.h"
 #include "../input/ButtonInput.h"
 #include "../display/DisplayManager.h"
@@ -23,11 +24,13 @@ private:
     SceneRegistry sceneRegistry;        // <-- Add this line
     SceneDirector sceneDirector;
     AudioProcessor audioProcessor;
+    FeatureRecorder featureRecorder;
     LEDStripController ledController;   // Uses audioFeatures and audioHistory
     TFT_eSPI tft = TFT_eSPI();                       // Must come before displayManager
     EncoderInput encoderInput;
     ButtonInput buttonInput;
     DisplayManager displayManager;
+    uint32_t appliedSettingsRevision = UINT32_MAX;
 
 public:
     MainController()
@@ -39,40 +42,56 @@ public:
     {}
 
     void begin() {
+        settingsManager.begin();
         sceneDirector.begin();
         audioProcessor.begin();
         displayManager.begin();
         ledController.begin();
         encoderInput.begin();
         buttonInput.begin();
-        FastLED.setBrightness(DEFAULT_BRIGHTNESS);
+#if ENABLE_FEATURE_RECORDING
+        featureRecorder.begin(FEATURE_RECORDING_PATH);
+#endif
+        ledController.setRenderSettings(settingsManager.getRenderSettings());
+        appliedSettingsRevision = settingsManager.getRevision();
         FastLED.clear();
         FastLED.show();
     }
 
     void update() {
-        static unsigned long lastFrame = 0;
-        const unsigned long frameInterval = 10; // ~30 FPS
+        // Audio is polled on every loop pass so the I2S buffers never back up; a
+        // new analysis lands whenever a full block is in. LED frames run on their
+        // own clock and interpolate between analyses (see FeatureInterpolator).
+        if (audioProcessor.captureAudio()) {
+            audioFeatures = audioProcessor.analyzeAudio();
+            featureRecorder.record(audioFeatures, millis());
+        }
 
-        unsigned long now = millis();
-        if (now - lastFrame < frameInterval) {
+        static unsigned long lastFrame = 0;
+        unsigned long frameStart = micros();
+        if (frameStart - lastFrame < LED_FRAME_INTERVAL_US) {
             return; // Skip this update, not enough time has passed
         }
-        lastFrame = now;
-
-        audioProcessor.captureAudio();
-
-        // Analyze and store into audioFeatures
-        audioFeatures = audioProcessor.analyzeAudio();
-
-        // Track the current frame in rolling history
-        audioHistory.addSnapshot(audioFeatures);
+        lastFrame = frameStart;
+        unsigned long now = millis();
 
 
         // Update all components
         encoderInput.update();
         buttonInput.update();
-        ledController.update();
+        settingsManager.update(now);
+        uint32_t settingsRevision = settingsManager.getRevision();
+        if (settingsRevision != appliedSettingsRevision) {
+            ledController.setRenderSettings(settingsManager.getRenderSettings());
+            appliedSettingsRevision = settingsRevision;
+        }
+        ledController.update();     // Shows the frame
+
+        // The status text and the TFT redraw are far slower than a frame, so they
+        // only run a few times a second
+        static unsigned long lastDisplayUpdate = 0;
+        if (now - lastDisplayUpdate < DISPLAY_UPDATE_INTERVAL_MS) return;
+        lastDisplayUpdate = now;
 
         String debugInfo =
     "Mood: " + moodHistory.getCurrentMoodName() +
@@ -89,7 +108,5 @@ public:
             false,
             String("")
         );
-
-        FastLED.show();
     }
 };
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <FastLED.h>
+#include <math.h>
+#include "RenderSettings.h"
+#include "PowerLimiter.h"
+#include "../config/Config.h"
+
+// Final per-strip stage between the layer stack and FastLED. Reads the strip's
+// render buffer and writes its output buffer in one fused pass:
+//   hue rotation + saturation  (one 3x3 Q8 matrix, skipped when identity)
+//   gamma + global brightness  (256-entry 8.8 lookup table)
+//   temporal dithering         (per-frame threshold added before truncating)
+// Writing to a separate buffer keeps effects that fade the previous frame from
+// compounding the adjustment frame after frame.
+class PostProcessor {
+public:
+    PostProcessor() {
+        configure(RenderSettings());
+    }
+
+    // Rebuild the matrix and lookup table; only called when settings change
+    void configure(const RenderSettings& settings) {
+        buildMatrix(settings.hueShift, settings.saturation);
+        buildLevels(settings.brightness);
+    }
+
+    // Advance the dither pattern once per rendered frame
+    void nextFrame() {
+        frame++;
+    }
+
+    // Returns the output's channel totals for the power estimate. A strip may be
+    // done in chunks: `first` is the chunk's offset into the strip, so the dither
+    // pattern lines up as if it were done in one pass.
+    ChannelSums apply(const CRGB* in, CRGB* out, int count, int first = 0) const {
+        ChannelSums sums;
+#if ENABLE_TEMPORAL_DITHER
+        // Bit-reversed 3-bit sequence, offset per pixel and channel so the pattern
+        // moves through the strip instead of flashing every LED in step
+        static const uint8_t ditherSequence[8] = { 0, 128, 64, 192, 32, 160, 96, 224 };
+        const uint8_t phase = (uint8_t)((frame + first) & 7);
+#endif
+        for (int i = 0; i < count; ++i) {
+            int r = in[i].r, g = in[i].g, b = in[i].b;
+            if (!identity) {
+                int nr = (matrix[0][0] * r + matrix[0][1] * g + matrix[0][2] * b + 128) >> 8;
+                int ng = (matrix[1][0] * r + matrix[1][1] * g + matrix[1][2] * b + 128) >> 8;
+                int nb = (matrix[2][0] * r + matrix[2][1] * g + matrix[2][2] * b + 128) >> 8;
+                r = clamp8(nr);
+                g = clamp8(ng);
+                b = clamp8(nb);
+            }
+#if ENABLE_TEMPORAL_DITHER
+            out[i].r = (levels[r] + ditherSequence[(phase + i) & 7]) >> 8;
+            out[i].g = (levels[g] + ditherSequence[(phase + i + 3) & 7]) >> 8;
+            out[i].b = (levels[b] + ditherSequence[(phase + i + 6) & 7]) >> 8;
+#else
+            out[i].r = (levels[r] + 128) >> 8;
+            out[i].g = (levels[g] + 128) >> 8;
+            out[i].b = (levels[b] + 128) >> 8;
+#endif
+            sums.r += out[i].r;
+            sums.g += out[i].g;
+            sums.b += out[i].b;
+        }
+        return sums;
+    }
+
+private:
+    static uint8_t clamp8(int v) {
+        return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+    }
+
+    // Luminance-preserving coefficients from the SVG feColorMatrix hueRotate/saturate filters
+    void buildMatrix(uint8_t hueShift, uint8_t saturation) {
+        identity = hueShift == 0 && saturation == 255;
+        if (identity) return;
+
+        float angle = hueShift * (2.0f * PI / 256.0f);
+        float c = cosf(angle), s = sinf(angle);
+        const float hue[3][3] = {
+            { 0.213f + c * 0.787f - s * 0.213f, 0.715f - c * 0.715f - s * 0.715f, 0.072f - c * 0.072f + s * 0.928f },
+            { 0.213f - c * 0.213f + s * 0.143f, 0.715f + c * 0.285f + s * 0.140f, 0.072f - c * 0.072f - s * 0.283f },
+            { 0.213f - c * 0.213f - s * 0.787f, 0.715f - c * 0.715f + s * 0.715f, 0.072f + c * 0.928f + s * 0.072f }
+        };
+
+        float k = saturation / 255.0f;
+        const float sat[3][3] = {
+            { 0.213f + 0.787f * k, 0.715f - 0.715f * k, 0.072f - 0.072f * k },
+            { 0.213f - 0.213f * k, 0.715f + 0.285f * k, 0.072f - 0.072f * k },
+            { 0.213f - 0.213f * k, 0.715f - 0.715f * k, 0.072f + 0.928f * k }
+        };
+
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                float sum = 0;
+                for (int i = 0; i < 3; ++i) sum += sat[row][i] * hue[i][col];
+                matrix[row][col] = (int16_t)lroundf(sum * 256.0f);
+            }
+        }
+    }
+
+    // 8.8 fixed point so dithering has fractional bits to work with; the top value
+    // stays at 255 * 256 so adding a dither threshold can never overflow a channel
+    void buildLevels(uint8_t brightness) {
+        for (int v = 0; v < 256; ++v) {
+            float linear = powf(v / 255.0f, OUTPUT_GAMMA);
+            levels[v] = (uint16_t)lroundf(linear * brightness * 256.0f);
+        }
+    }
+
+    int16_t matrix[3][3] = {};
+    bool identity = true;
+    uint16_t levels[256];
+    uint8_t frame = 0;
+};
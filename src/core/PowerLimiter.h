@@ -0,0 +1,94 @@
+#pragma once
+
+#include <FastLED.h>
+#include <algorithm>
+#include "../config/Config.h"
+#include "../config/StripConfig.h"
+
+// Channel totals of one strip's output buffer, gathered during the post-process pass
+struct ChannelSums {
+    uint32_t r = 0;
+    uint32_t g = 0;
+    uint32_t b = 0;
+};
+
+// Current budget for all strips. The estimate is linear in the channel sums
+// (per-channel mA at full drive plus a fixed quiescent draw per LED), so it costs
+// three additions per pixel inside the existing post-process loop. When a strip or
+// the whole rig would exceed its cap, the strip's output is scaled down on the spot;
+// the gain then recovers slowly so beat flashes dim instead of pumping.
+class PowerLimiter {
+public:
+    PowerLimiter() {
+        for (float& g : gain) g = 1.0f;
+    }
+
+    static uint32_t estimateMilliamps(const ChannelSums& sums, int ledCount) {
+        uint32_t drive = (sums.r * POWER_MA_RED + sums.g * POWER_MA_GREEN + sums.b * POWER_MA_BLUE) / 255;
+        return drive + (uint32_t)ledCount * POWER_MA_IDLE;
+    }
+
+    // Record one strip's unlimited demand for this frame
+    void setDemand(int strip, const ChannelSums& sums, int ledCount) {
+        demand[strip] = estimateMilliamps(sums, ledCount);
+        idle[strip] = (uint32_t)ledCount * POWER_MA_IDLE;
+    }
+
+    // Work out this frame's gain per strip; call once all strips have reported
+    void resolve(int stripCount) {
+        float target[stripTableSize];
+        uint32_t total = 0;
+        uint32_t totalIdle = 0;
+        for (int i = 0; i < stripCount; ++i) {
+            target[i] = capGain(demand[i], idle[i], POWER_LIMIT_MA_PER_STRIP);
+            total += scaled(demand[i], idle[i], target[i]);
+            totalIdle += idle[i];
+        }
+
+        // The global cap scales every strip by the same factor on top of its own limit
+        float globalGain = capGain(total, totalIdle, POWER_LIMIT_MA_TOTAL);
+        totalMilliamps = 0;
+        limitedStrips = 0;
+        for (int i = 0; i < stripCount; ++i) {
+            float wanted = target[i] * globalGain;
+            // Drop at once to stay under the cap, recover gradually
+            gain[i] = wanted < gain[i] ? wanted : std::min(wanted, gain[i] + POWER_GAIN_RELEASE);
+            milliamps[i] = scaled(demand[i], idle[i], gain[i]);
+            totalMilliamps += milliamps[i];
+            if (gain[i] < 1.0f) limitedStrips++;
+        }
+    }
+
+    // Scale a strip's output by its gain; a no-op unless the strip is being limited
+    void apply(int strip, CRGB* leds, int count) const {
+        if (gain[strip] >= 1.0f) return;
+        uint8_t scale = (uint8_t)(gain[strip] * 255.0f);
+        for (int i = 0; i < count; ++i) leds[i].nscale8(scale);
+    }
+
+    uint32_t getStripMilliamps(int strip) const { return milliamps[strip]; }
+    uint32_t getStripDemand(int strip) const { return demand[strip]; }
+    float getStripGain(int strip) const { return gain[strip]; }
+    uint32_t getTotalMilliamps() const { return totalMilliamps; }
+    float getWatts() const { return totalMilliamps * POWER_SUPPLY_VOLTS / 1000.0f; }
+    int getLimitedStripCount() const { return limitedStrips; }
+
+private:
+    // Gain that keeps `ma` under `cap`; only the drive current above idle can be scaled
+    static float capGain(uint32_t ma, uint32_t idleMa, uint32_t cap) {
+        if (cap == 0 || ma <= cap) return 1.0f;
+        if (cap <= idleMa) return 0.0f;
+        return (float)(cap - idleMa) / (float)(ma - idleMa);
+    }
+
+    static uint32_t scaled(uint32_t ma, uint32_t idleMa, float g) {
+        return idleMa + (uint32_t)((ma - idleMa) * g);
+    }
+
+    uint32_t demand[stripTableSize] = {};
+    uint32_t idle[stripTableSize] = {};
+    uint32_t milliamps[stripTableSize] = {};
+    float gain[stripTableSize];
+    uint32_t totalMilliamps = 0;
+    int limitedStrips = 0;
+};
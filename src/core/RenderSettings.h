@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+#include "../config/Config.h"
+
+// Live output parameters applied by LEDStripController on every frame
+struct RenderSettings {
+    uint8_t brightness = DEFAULT_BRIGHTNESS;
+    uint8_t speed = 100;        // Percent of normal layer update rate
+    uint8_t hueShift = 0;       // 0..255 maps to a full turn of the colour wheel
+    uint8_t saturation = 255;   // 255 leaves colours untouched, 0 is greyscale
+
+    bool operator==(const RenderSettings& o) const {
+        return brightness == o.brightness && speed == o.speed && hueShift == o.hueShift && saturation == o.saturation;
+    }
+    bool operator!=(const RenderSettings& o) const { return !(*this == o); }
+};
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "../config/Config.h"
+#include "../utils/ProfileClock.h"
+#ifdef NATIVE_BUILD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// ==== Render lanes ====
+// A fixed set of lanes that run one batch of independent jobs (a strip's
+// render, a chunk of post-processing) and meet at a barrier before the frame
+// goes out. The caller of run() is lane 0; every other lane is a helper started
+// once by begin(): a FreeRTOS task pinned to RENDER_WORKER_CORE on the ESP32, a
+// std::thread in the native build so the sim and bench exercise the same code.
+//
+// Jobs are dealt to the lanes longest-predicted-first, each to the lane with the
+// least predicted work so far, from the caller's measured cost of the job last
+// frame. A lane works through its own queue from the front; once empty it
+// steals from the back of another lane's, where the cheapest jobs are, so a
+// bad prediction costs at most one small job of imbalance. Nothing is
+// allocated per batch.
+class RenderWorkers {
+public:
+    using Job = void (*)(void* context, int job);
+
+    static constexpr int maxLanes = 2;
+    static constexpr int maxJobs = RENDER_MAX_JOBS;
+
+    struct Stats {
+        uint32_t batches = 0;
+        uint32_t serialBatches = 0;       // Predicted too cheap to be worth waking the helpers
+        uint32_t jobs = 0;
+        uint32_t steals = 0;              // Jobs a lane took from another lane's queue
+        uint32_t laneJobs[maxLanes] = {};
+        uint32_t lastWallUs = 0;          // Last batch from dispatch to barrier
+        uint32_t lastWorkUs = 0;          // Summed job time of the last batch
+        float efficiency = 1.0f;          // EMA of work / (wall * lanes) over parallel batches: 1.0 is perfect scaling
+    };
+
+    RenderWorkers() = default;
+    RenderWorkers(const RenderWorkers&) = delete;
+    RenderWorkers& operator=(const RenderWorkers&) = delete;
+    ~RenderWorkers() { end(); }
+
+    // Starts lanes - 1 helpers. Returns false, and keeps the lanes that did
+    // start, if a helper can't be created.
+    bool begin(int requested) {
+        end();
+        if (requested < 1) requested = 1;
+        if (requested > maxLanes) requested = maxLanes;
+        stopping = false;
+        lanes = 1;
+        for (int lane = 1; lane < requested; ++lane) {
+            helpers[lane].owner = this;
+            helpers[lane].lane = lane;
+            if (!startHelper(helpers[lane])) break;
+            lanes++;
+        }
+        stats = Stats();
+        return lanes == requested;
+    }
+
+    // Stops the helpers; run() then works on the caller alone
+    void end() {
+        if (lanes <= 1) return;
+        stopping = true;
+        pending = lanes - 1;
+        wakeHelpers();
+        waitForHelpers();
+        joinHelpers();
+        lanes = 1;
+    }
+
+    int getLanes() const { return lanes; }
+    const Stats& getStats() const { return stats; }
+
+    // Runs job(context, j) for every j in [0, count) and returns once all have
+    // finished. predictedUs[j] orders and balances the jobs (null: all alike);
+    // measuredUs[j], when given, receives each job's time for next frame's
+    // prediction. A batch predicted under RENDER_PARALLEL_MIN_US in all runs on
+    // the caller alone. Jobs of one batch must not touch each other's data.
+    void run(Job job, void* context, int count, const uint32_t* predictedUs, uint32_t* measuredUs) {
+        if (count <= 0) return;
+        if (count > maxJobs) count = maxJobs;
+        uint32_t start = profileMicros();
+
+        int active = lanes;
+        if (predictedUs && active > 1) {
+            uint32_t predicted = 0;
+            for (int j = 0; j < count; ++j) predicted += predictedUs[j];
+            if (predicted < RENDER_PARALLEL_MIN_US) active = 1;
+        }
+
+        jobFn = job;
+        jobContext = context;
+        jobUs = measuredUs;
+        deal(count, active, predictedUs);
+        for (int lane = 0; lane < lanes; ++lane) {
+            laneWorkUs[lane] = 0;
+            laneDone[lane] = 0;
+            laneSteals[lane] = 0;
+        }
+
+        if (active > 1) {
+            pending = lanes - 1;
+            wakeHelpers();
+            drain(0);
+            waitForHelpers();
+        } else {
+            drain(0);
+        }
+
+        uint32_t wallUs = profileMicros() - start;
+        uint32_t workUs = 0;
+        stats.batches++;
+        for (int lane = 0; lane < lanes; ++lane) {
+            workUs += laneWorkUs[lane];
+            stats.jobs += laneDone[lane];
+            stats.steals += laneSteals[lane];
+            stats.laneJobs[lane] += laneDone[lane];
+        }
+        stats.lastWallUs = wallUs;
+        stats.lastWorkUs = workUs;
+        if (active == 1) {
+            stats.serialBatches++;
+        } else if (wallUs > 0) {
+            float efficiency = (float)workUs / ((float)wallUs * active);
+            if (efficiency > 1.0f) efficiency = 1.0f;
+            bool first = stats.batches - stats.serialBatches == 1;
+            stats.efficiency = first ? efficiency : stats.efficiency * 0.95f + efficiency * 0.05f;
+        }
+    }
+
+private:
+    struct Helper {
+        RenderWorkers* owner = nullptr;
+        int lane = 0;
+#ifdef NATIVE_BUILD
+        std::thread thread;
+#else
+        TaskHandle_t task = nullptr;
+#endif
+    };
+
+    int lanes = 1;
+    Helper helpers[maxLanes];
+    std::atomic<bool> stopping{ false };
+    std::atomic<int> pending{ 0 };
+
+    // The batch being run; written before the helpers are woken
+    Job jobFn = nullptr;
+    void* jobContext = nullptr;
+    uint32_t* jobUs = nullptr;
+
+    // Each lane's queue is queue[lane][head, tail), with head and tail packed in
+    // one word so the owner taking the front and a thief taking the back can't
+    // both get the last job
+    uint8_t queue[maxLanes][maxJobs];
+    std::atomic<uint32_t> range[maxLanes];
+
+    // Written only by their own lane during a batch, read after the barrier
+    uint32_t laneWorkUs[maxLanes];
+    uint32_t laneDone[maxLanes];
+    uint32_t laneSteals[maxLanes];
+
+    Stats stats;
+
+#ifdef NATIVE_BUILD
+    std::mutex signalMutex;
+    std::condition_variable wakeSignal;
+    std::condition_variable doneSignal;
+    uint32_t generation = 0;
+#else
+    TaskHandle_t caller = nullptr;
+#endif
+
+    // Longest predicted job first, each to the lane with the least predicted
+    // work. A single lane keeps the caller's order, so a serial run doesn't
+    // depend on timing.
+    void deal(int count, int active, const uint32_t* predictedUs) {
+        if (active == 1) predictedUs = nullptr;
+        uint8_t order[maxJobs];
+        for (int j = 0; j < count; ++j) {
+            int k = j;
+            uint32_t cost = predictedUs ? predictedUs[j] : 1;
+            while (k > 0 && (predictedUs ? predictedUs[order[k - 1]] : 1) < cost) {
+                order[k] = order[k - 1];
+                k--;
+            }
+            order[k] = (uint8_t)j;
+        }
+        uint32_t load[maxLanes] = {};
+        uint16_t tail[maxLanes] = {};
+        for (int k = 0; k < count; ++k) {
+            int lane = 0;
+            for (int l = 1; l < active; ++l) {
+                if (load[l] < load[lane]) lane = l;
+            }
+            load[lane] += predictedUs ? predictedUs[order[k]] + 1 : 1;
+            queue[lane][tail[lane]++] = order[k];
+        }
+        for (int lane = 0; lane < lanes; ++lane) range[lane].store((uint32_t)tail[lane] << 16);
+    }
+
+    bool takeFront(int lane, int& job) {
+        uint32_t r = range[lane].load();
+        for (;;) {
+            uint32_t head = r & 0xFFFF, tail = r >> 16;
+            if (head >= tail) return false;
+            if (range[lane].compare_exchange_weak(r, (tail << 16) | (head + 1))) {
+                job = queue[lane][head];
+                return true;
+            }
+        }
+    }
+
+    bool takeBack(int lane, int& job) {
+        uint32_t r = range[lane].load();
+        for (;;) {
+            uint32_t head = r & 0xFFFF, tail = r >> 16;
+            if (head >= tail) return false;
+            if (range[lane].compare_exchange_weak(r, ((tail - 1) << 16) | head)) {
+                job = queue[lane][tail - 1];
+                return true;
+            }
+        }
+    }
+
+    void drain(int lane) {
+        int job;
+        for (;;) {
+            bool stolen = false;
+            if (!takeFront(lane, job)) {
+                for (int other = 1; other < lanes && !stolen; ++other) {
+                    stolen = takeBack((lane + other) % lanes, job);
+                }
+                if (!stolen) return;
+            }
+            uint32_t start = profileMicros();
+            jobFn(jobContext, job);
+            uint32_t us = profileMicros() - start;
+            if (jobUs) jobUs[job] = us;
+            laneWorkUs[lane] += us;
+            laneDone[lane]++;
+            if (stolen) laneSteals[lane]++;
+        }
+    }
+
+    // A helper's whole life: wait for a batch, drain, report, until stopped
+    void helperLoop(int lane, uint32_t seen) {
+        for (;;) {
+#ifdef NATIVE_BUILD
+            {
+                std::unique_lock<std::mutex> lock(signalMutex);
+                wakeSignal.wait(lock, [&] { return generation != seen; });
+                seen = generation;
+            }
+#else
+            (void)seen;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif
+            bool stop = stopping;
+            if (!stop) drain(lane);
+            finishLane();
+            if (stop) return;
+        }
+    }
+
+    void finishLane() {
+        if (pending.fetch_sub(1) != 1) return;
+#ifdef NATIVE_BUILD
+        std::lock_guard<std::mutex> lock(signalMutex);
+        doneSignal.notify_one();
+#else
+        xTaskNotifyGive(caller);
+#endif
+    }
+
+    void wakeHelpers() {
+#ifdef NATIVE_BUILD
+        {
+            std::lock_guard<std::mutex> lock(signalMutex);
+            generation++;
+        }
+        wakeSignal.notify_all();
+#else
+        caller = xTaskGetCurrentTaskHandle();
+        for (int lane = 1; lane < lanes; ++lane) xTaskNotifyGive(helpers[lane].task);
+#endif
+    }
+
+    void waitForHelpers() {
+#ifdef NATIVE_BUILD
+        std::unique_lock<std::mutex> lock(signalMutex);
+        doneSignal.wait(lock, [&] { return pending.load() == 0; });
+#else
+        while (pending.load() != 0) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif
+    }
+
+#ifdef NATIVE_BUILD
+    // The helper starts from the current generation so it waits for the next batch
+    bool startHelper(Helper& helper) {
+        uint32_t seen;
+        {
+            std::lock_guard<std::mutex> lock(signalMutex);
+            seen = generation;
+        }
+        helper.thread = std::thread([&helper, seen] { helper.owner->helperLoop(helper.lane, seen); });
+        return true;
+    }
+
+    void joinHelpers() {
+        for (int lane = 1; lane < lanes; ++lane) {
+            if (helpers[lane].thread.joinable()) helpers[lane].thread.join();
+        }
+    }
+#else
+    static void helperTask(void* arg) {
+        Helper& helper = *static_cast<Helper*>(arg);
+        helper.owner->helperLoop(helper.lane, 0);
+        vTaskDelete(nullptr);
+    }
+
+    bool startHelper(Helper& helper) {
+        return xTaskCreatePinnedToCore(helperTask, "render", RENDER_WORKER_STACK, &helper,
+                                       RENDER_WORKER_PRIORITY, &helper.task, RENDER_WORKER_CORE) == pdPASS;
+    }
+
+    // The helpers delete themselves once they have reported back
+    void joinHelpers() {
+        for (int lane = 1; lane < lanes; ++lane) helpers[lane].task = nullptr;
+    }
+#endif
+};
@@ -1,45 +1,98 @@
 #pragma once
 
 #include <Arduino.h>
-#include <map>
+#include <atomic>
+#ifndef NATIVE_BUILD
+#include <Preferences.h>
+#endif
 #include "Debug.h"
+#include "RenderSettings.h"
 #include "../config/Config.h"
 
-enum class Setting {
-    BRIGHTNESS = DEFAULT_BRIGHTNESS,
+// Dense indices into the settings table; COUNT must stay last
+enum class Setting : uint8_t {
+    BRIGHTNESS,
     SPEED,
     HUE,
     SATURATION,
     COUNT
 };
 
+// Index-addressed parameter store. The input side writes through set()/adjust();
+// readers (render loop, display) use get(), which is a single relaxed atomic load.
+// Values are persisted to NVS as one blob, written only after they have been left
+// alone for SETTINGS_SAVE_DELAY_MS and only if they differ from what is stored.
 class SettingsManager {
 public:
+    static constexpr size_t settingCount = static_cast<size_t>(Setting::COUNT);
+
+    struct SettingInfo {
+        const char* name;
+        int16_t minValue;
+        int16_t maxValue;
+        int16_t defaultValue;
+        bool wraps;   // Hue wraps around instead of stopping at the ends
+    };
+
+    static constexpr SettingInfo settingInfo[settingCount] = {
+        { "BRIGHTNESS", 0,   255, DEFAULT_BRIGHTNESS, false },
+        { "SPEED",      10,  250, 100,                false },
+        { "HUE",        0,   255, 0,                  true  },
+        { "SATURATION", 0,   255, 255,                false },
+    };
+
     SettingsManager() {
-        values[Setting::BRIGHTNESS] = 128;
-        values[Setting::SPEED] = 100;
-        values[Setting::HUE] = 0;
-        values[Setting::SATURATION] = 255;
-        currentSetting = Setting::BRIGHTNESS;  
+        for (size_t i = 0; i < settingCount; ++i) {
+            values[i].store(settingInfo[i].defaultValue, std::memory_order_relaxed);
+            persisted[i] = settingInfo[i].defaultValue;
+        }
+        currentSetting = Setting::BRIGHTNESS;
+    }
+
+    // Load persisted values; defaults stay in place if nothing valid is stored
+    void begin() {
+#ifndef NATIVE_BUILD
+        Preferences prefs;
+        if (!prefs.begin(SETTINGS_NAMESPACE, true)) return;
+        StoredBlob blob;
+        size_t size = prefs.getBytes(SETTINGS_KEY, &blob, sizeof(blob));
+        prefs.end();
+        if (size != sizeof(blob) || blob.version != blobVersion) return;
+        for (size_t i = 0; i < settingCount; ++i) {
+            int16_t v = clampValue(i, blob.values[i]);
+            values[i].store(v, std::memory_order_relaxed);
+            persisted[i] = v;
+        }
+        revision.fetch_add(1, std::memory_order_release);
+        Debug::log(Debug::INFO, "SettingsManager: Loaded settings from NVS");
+#endif
     }
 
     int get(Setting setting) const {
-        auto it = values.find(setting);
-        return it != values.end() ? it->second : 0;
+        size_t i = static_cast<size_t>(setting);
+        return i < settingCount ? values[i].load(std::memory_order_relaxed) : 0;
     }
 
     void set(Setting setting, int value) {
-        values[setting] = value;
-        Debug::logf(Debug::DEBUG, "SettingsManager: Set %s (%d) to %d\n", settingName(setting).c_str(), static_cast<int>(setting), value);
+        size_t i = static_cast<size_t>(setting);
+        if (i >= settingCount) return;
+        store(i, clampValue(i, value));
+        Debug::logf(Debug::DEBUG, "SettingsManager: Set %s (%d) to %d", settingInfo[i].name, (int)i, get(setting));
     }
 
     void adjust(int delta) {
-        values[currentSetting] = constrain(values[currentSetting] + delta, 0, 255);
-        Debug::logf(Debug::DEBUG, "SettingsManager: Adjusted %s (%d) to %d\n", settingName(currentSetting).c_str(), static_cast<int>(currentSetting), values[currentSetting]);
+        size_t i = static_cast<size_t>(currentSetting);
+        int value = get(currentSetting) + delta;
+        if (settingInfo[i].wraps) {
+            int span = settingInfo[i].maxValue - settingInfo[i].minValue + 1;
+            value = settingInfo[i].minValue + ((value - settingInfo[i].minValue) % span + span) % span;
+        }
+        store(i, clampValue(i, value));
+        Debug::logf(Debug::DEBUG, "SettingsManager: Adjusted %s (%d) to %d", settingInfo[i].name, (int)i, get(currentSetting));
     }
 
     void next() {
-        currentSetting = static_cast<Setting>((static_cast<int>(currentSetting) + 1) % static_cast<int>(Setting::COUNT));
+        currentSetting = static_cast<Setting>((static_cast<size_t>(currentSetting) + 1) % settingCount);
         Debug::logf(Debug::DEBUG, "SettingsManager: Switched to setting %s (%d)", settingName(currentSetting).c_str(), static_cast<int>(currentSetting));
     }
 
@@ -47,19 +100,81 @@ public:
         return currentSetting;
     }
 
+    // Bumped on every change so consumers can skip work when nothing moved
+    uint32_t getRevision() const {
+        return revision.load(std::memory_order_acquire);
+    }
+
+    RenderSettings getRenderSettings() const {
+        RenderSettings rs;
+        rs.brightness = get(Setting::BRIGHTNESS);
+        rs.speed = get(Setting::SPEED);
+        rs.hueShift = get(Setting::HUE);
+        rs.saturation = get(Setting::SATURATION);
+        return rs;
+    }
+
+    // Call from the main loop; writes to NVS once changes have settled
+    void update(unsigned long now) {
+        if (!dirty || now - lastChange < SETTINGS_SAVE_DELAY_MS) return;
+        dirty = false;
+        save();
+    }
+
     static String settingName(Setting setting) {
-        switch (setting) {
-            case Setting::BRIGHTNESS: return "BRIGHTNESS";
-            case Setting::SPEED: return "SPEED";
-            case Setting::HUE: return "HUE";
-            case Setting::SATURATION: return "SATURATION";
-            default: return "UNKNOWN";
-        }
+        size_t i = static_cast<size_t>(setting);
+        return i < settingCount ? settingInfo[i].name : "UNKNOWN";
     }
 
 private:
-    std::map<Setting, int> values;
+    static constexpr const char* SETTINGS_NAMESPACE = "glimmer";
+    static constexpr const char* SETTINGS_KEY = "settings";
+    static constexpr uint8_t blobVersion = 1;
+
+    struct StoredBlob {
+        uint8_t version = blobVersion;
+        int16_t values[settingCount];
+    };
+
+    static int16_t clampValue(size_t i, int value) {
+        return constrain(value, settingInfo[i].minValue, settingInfo[i].maxValue);
+    }
+
+    void store(size_t i, int16_t value) {
+        if (values[i].exchange(value, std::memory_order_relaxed) == value) return;
+        revision.fetch_add(1, std::memory_order_release);
+        dirty = true;
+        lastChange = millis();
+    }
+
+    void save() {
+        StoredBlob blob;
+        bool changed = false;
+        for (size_t i = 0; i < settingCount; ++i) {
+            blob.values[i] = values[i].load(std::memory_order_relaxed);
+            changed |= blob.values[i] != persisted[i];
+        }
+        if (!changed) return;   // e.g. turned up and back down again
+#ifndef NATIVE_BUILD
+        Preferences prefs;
+        if (!prefs.begin(SETTINGS_NAMESPACE, false)) return;
+        size_t written = prefs.putBytes(SETTINGS_KEY, &blob, sizeof(blob));
+        prefs.end();
+        if (written != sizeof(blob)) {
+            Debug::log(Debug::ERROR, "SettingsManager: NVS write failed");
+            return;
+        }
+        Debug::log(Debug::DEBUG, "SettingsManager: Saved settings to NVS");
+#endif
+        for (size_t i = 0; i < settingCount; ++i) persisted[i] = blob.values[i];
+    }
+
+    std::atomic<int16_t> values[settingCount];
+    int16_t persisted[settingCount];
+    std::atomic<uint32_t> revision{0};
     Setting currentSetting;
+    bool dirty = false;
+    unsigned long lastChange = 0;
 };
 
 extern SettingsManager settingsManager;
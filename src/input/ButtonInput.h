@@ -1,60 +1,87 @@
 #pragma once
 
-#include <Button2.h>
+#include <Arduino.h>
 
 #include "../core/LEDStripController.h"
-// Remove duplicate forward declaration since we already include the header
-// class LEDStripController;
+#include "InputEventQueue.h"
 
+// Push buttons read by GPIO interrupts rather than polled every frame. Presses are
+// debounced in the interrupt and queued; update() applies them once per frame.
+// The interrupt fires on both edges and reads the pin level, so a press counts only
+// after the button has been released for edgeDebounce: contact bounce on either
+// edge never makes a second click.
 class ButtonInput {
 private:
-    uint8_t buttonPin1;
-    uint8_t buttonPin2;
+    struct ButtonState {
+        ButtonInput* owner = nullptr;
+        uint8_t pin = 0;
+        uint8_t index = 0;
+        volatile bool pressed = false;
+        volatile uint32_t releasedAt = 0;
+    };
+
+    static constexpr uint32_t edgeDebounce = 50;
+    ButtonState buttons[2];
+    InputEventQueue<16> events;
     unsigned long lastPressTime = 0;
     const unsigned long debounceDelay = 500; // Longer debounce to prevent rapid triggers
-    Button2 nextModeBtn;
-    Button2 autoModeBtn;
     LEDStripController& lEDStripController;
 
-public:
-    ButtonInput(LEDStripController& hybrid, uint8_t pin1, uint8_t pin2) :
-                                    lEDStripController(hybrid),
-                                    buttonPin1(pin1),
-                                    buttonPin2(pin2),
-                                    nextModeBtn(pin1),
-                                    autoModeBtn(pin2) {}
-
-    void begin() {
-        // Configure internal pullup resistors for the buttons
-        pinMode(buttonPin1, INPUT_PULLUP);
-        pinMode(buttonPin2, INPUT_PULLUP);
-
-        // Configure Button2 instances with debounce time
-        nextModeBtn.setDebounceTime(50);
-        autoModeBtn.setDebounceTime(50);
+    static void IRAM_ATTR onButtonEdge(void* arg) {
+        ButtonState* button = static_cast<ButtonState*>(arg);
+        uint32_t now = millis();
+        if (digitalRead(button->pin) != LOW) {
+            button->pressed = false;
+            button->releasedAt = now;
+            return;
+        }
+        if (!button->pressed && now - button->releasedAt > edgeDebounce) {
+            button->owner->events.push({ InputEventType::ButtonClick, (int8_t)button->index, now });
+        }
+        button->pressed = true;
+    }
 
-        // Use different event for more reliable operation
-        nextModeBtn.setClickHandler([this](Button2 &btn) {
-            unsigned long now = millis();
+    void onClick(uint8_t index, unsigned long now) {
+        if (index == 0) {
             // Only allow button press every 500ms to prevent rapid triggering
             if (now - lastPressTime > debounceDelay) {
                 Serial.println("Button 1 pressed - switching animations");
                 lEDStripController.switchAllAnimations();
                 lastPressTime = now;
             }
-        });
-
-        autoModeBtn.setClickHandler([this](Button2 &btn) {
+        } else {
             Serial.println("Button 2 pressed");
             // Uncomment when function is implemented
             // lEDStripController.toggleAuto();
-        });
+        }
+    }
+
+public:
+    ButtonInput(LEDStripController& hybrid, uint8_t pin1, uint8_t pin2) :
+                                    lEDStripController(hybrid) {
+        buttons[0].pin = pin1;
+        buttons[1].pin = pin2;
+    }
+
+    void begin() {
+        for (uint8_t i = 0; i < 2; ++i) {
+            ButtonState& button = buttons[i];
+            button.owner = this;
+            button.index = i;
+            // Configure internal pullup resistors for the buttons
+            pinMode(button.pin, INPUT_PULLUP);
+            button.pressed = digitalRead(button.pin) == LOW;
+            attachInterruptArg(digitalPinToInterrupt(button.pin), onButtonEdge, &button, CHANGE);
+        }
     }
 
     bool update() {
-        // Only call loop on the button objects
-        nextModeBtn.loop();
-        autoModeBtn.loop();
-        return true;
+        InputEvent event;
+        bool handled = false;
+        while (events.pop(event)) {
+            onClick(event.value, event.timeMs);
+            handled = true;
+        }
+        return handled;
     }
 };
@@ -1,56 +1,108 @@
 #pragma once
 
 #include <Arduino.h>
+#include "../config/Config.h"
 #include "../core/SettingsManager.h"
+#include "InputEventQueue.h"
 
+// Rotary encoder decoded in GPIO interrupts. Every edge on A/B runs through a
+// quadrature state table, so no detent is lost however long a frame takes; whole
+// detents and debounced clicks are queued and applied once per frame in update().
+// The button is read on both edges; a press counts only once the pin has been
+// released for the debounce time, so release bounce doesn't click again.
 class EncoderInput {
 public:
     EncoderInput(uint8_t pinA, uint8_t pinB, uint8_t buttonPin, SettingsManager& settings)
         : pinA(pinA), pinB(pinB), buttonPin(buttonPin), settings(settings) {}
 
-
-
     void begin() {
         pinMode(pinA, INPUT_PULLUP);
         pinMode(pinB, INPUT_PULLUP);
         pinMode(buttonPin, INPUT_PULLUP);
+
+        state = readPins();
+        buttonPressed = digitalRead(buttonPin) == LOW;
+        attachInterruptArg(digitalPinToInterrupt(pinA), onQuadratureEdge, this, CHANGE);
+        attachInterruptArg(digitalPinToInterrupt(pinB), onQuadratureEdge, this, CHANGE);
+        attachInterruptArg(digitalPinToInterrupt(buttonPin), onButtonEdge, this, CHANGE);
     }
 
+    // Apply everything the interrupts queued since the last frame
     void update() {
-        int a = digitalRead(pinB);
-        int b = digitalRead(pinA);
-        bool pressed = digitalRead(buttonPin) == LOW;
-        unsigned long now = millis();
-
-        // Rotary detection (simple state change)
-        if (a != lastA) {
-            if (b != a) {
-                settings.adjust(1);
-            } else {
-                settings.adjust(-1);
+        InputEvent event;
+        while (events.pop(event)) {
+            switch (event.type) {
+                case InputEventType::EncoderTurn:
+                    settings.adjust(event.value);
+                    lastTurnTime = event.timeMs;
+                    break;
+                case InputEventType::EncoderClick:
+                    settings.next();
+                    break;
+                default:
+                    break;
             }
-            lastTurnTime = now;
-        }
-        lastA = a;
-
-        // Button press
-        if (pressed && !wasPressed && now - lastClick > debounce) {
-            settings.next();
-            lastClick = now;
         }
-        wasPressed = pressed;
 
-        /*if (display && now - lastTurnTime < displayTimeout) {
+        /*if (display && millis() - lastTurnTime < displayTimeout) {
             display->showSetting(settings.getCurrentSetting(), settings.get(settings.getCurrentSetting()));
         }*/
     }
 
+    uint32_t droppedEvents() const {
+        return events.droppedCount();
+    }
+
 private:
+    // Indexed by (previous << 2) | current, with pins packed as (B << 1) | A.
+    // Valid Gray-code steps give +1/-1; no change or a skipped state gives 0.
+    static constexpr int8_t transitionTable[16] = {
+         0, -1,  1,  0,
+         1,  0,  0, -1,
+        -1,  0,  0,  1,
+         0,  1, -1,  0
+    };
+
+    uint8_t IRAM_ATTR readPins() const {
+        return (digitalRead(pinB) << 1) | digitalRead(pinA);
+    }
+
+    static void IRAM_ATTR onQuadratureEdge(void* arg) {
+        EncoderInput* self = static_cast<EncoderInput*>(arg);
+        uint8_t current = self->readPins();
+        self->steps += transitionTable[(self->state << 2) | current];
+        self->state = current;
+
+        if (self->steps >= ENCODER_STEPS_PER_DETENT || self->steps <= -ENCODER_STEPS_PER_DETENT) {
+            int8_t detents = self->steps / ENCODER_STEPS_PER_DETENT;
+            self->steps -= detents * ENCODER_STEPS_PER_DETENT;
+            self->events.push({ InputEventType::EncoderTurn, detents, (uint32_t)millis() });
+        }
+    }
+
+    static void IRAM_ATTR onButtonEdge(void* arg) {
+        EncoderInput* self = static_cast<EncoderInput*>(arg);
+        uint32_t now = millis();
+        if (digitalRead(self->buttonPin) != LOW) {
+            self->buttonPressed = false;
+            self->releasedAt = now;
+            return;
+        }
+        if (!self->buttonPressed && now - self->releasedAt > debounce) {
+            self->events.push({ InputEventType::EncoderClick, 0, now });
+        }
+        self->buttonPressed = true;
+    }
+
     uint8_t pinA, pinB, buttonPin;
-    int lastA = HIGH;
-    bool wasPressed = false;
 
-    unsigned long lastClick = 0;
+    // Touched only from the interrupt handlers
+    volatile uint8_t state = 0;
+    volatile int8_t steps = 0;
+    volatile bool buttonPressed = false;
+    volatile uint32_t releasedAt = 0;
+
+    InputEventQueue<32> events;
     unsigned long lastTurnTime = 0;
 
     static constexpr unsigned long debounce = 250;
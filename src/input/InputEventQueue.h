@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Input events produced by GPIO interrupt handlers and consumed once per frame.
+
+enum class InputEventType : uint8_t {
+    EncoderTurn,     // value = detents turned (+ clockwise)
+    EncoderClick,
+    ButtonClick      // value = button index
+};
+
+struct InputEvent {
+    InputEventType type;
+    int8_t value;
+    uint32_t timeMs;
+};
+
+// Lock-free single-producer/single-consumer ring. The producer side runs in ISRs;
+// ESP32 GPIO interrupts are dispatched one at a time from a single handler, so
+// several pins sharing one queue still count as one producer. Capacity must be a
+// power of two and holds Capacity - 1 events; when full, new events are dropped
+// and counted.
+template<uint8_t Capacity>
+class InputEventQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // ISR side
+    bool IRAM_ATTR push(const InputEvent& event) {
+        uint8_t h = head.load(std::memory_order_relaxed);
+        uint8_t next = (h + 1) & (Capacity - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        events[h] = event;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Frame side; a single load and compare when nothing happened
+    bool pop(InputEvent& event) {
+        uint8_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        event = events[t];
+        tail.store((t + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+    }
+
+    uint32_t droppedCount() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    InputEvent events[Capacity];
+    std::atomic<uint8_t> head{0};
+    std::atomic<uint8_t> tail{0};
+    std::atomic<uint32_t> dropped{0};
+};
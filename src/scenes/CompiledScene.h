@@ -0,0 +1,136 @@
+#pragma once
+
+#include <FastLED.h>
+#include <deque>
+#include <tuple>
+#include <utility>
+#include "../config/Config.h"
+#include "../audio/AudioFeatures.h"
+#include "../audio/AudioSnapshot.h"
+#include "../animations/Animation.h"
+#include "../animations/VisualLayer.h"
+#include "../core/LedArena.h"
+
+// A scene whose base animation and layers are fixed at compile time.
+//
+// A dynamic scene costs a factory call per effect and a virtual call per effect
+// per frame, and its layers go through LayerManager one at a time. A compiled
+// scene holds its effects by value, so each call below names the concrete
+// class and the compiler can inline the whole frame. The strip makes three
+// virtual calls per frame into it, whatever the number of layers.
+//
+// Compiled layers always add at full opacity; saturating addition doesn't
+// depend on order, so fusable layers share one chunked pass and the rest draw
+// whole. They run outside the quality governor and the output cache, but get
+// events and sleep while dormant as in LayerManager. Layers a scene definition
+// lists on top still go through the strip's LayerManager.
+class CompiledScene {
+public:
+    virtual ~CompiledScene() = default;
+    virtual void attach(int ledCount, ScratchAllocator& scratch) = 0;
+    virtual void drawAnimation(CRGB* leds, int count, const AudioFeatures& audio, const FrameContext& frame) = 0;
+    virtual void updateLayers(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame) = 0;
+    virtual void renderLayers(CRGB* leds, int count) = 0;
+    virtual void dispatchEvent(const AudioEvent& event) = 0;
+
+    // getName() of each layer in order; returns how many were written
+    virtual int layerNames(const char** out, int max) const = 0;
+};
+
+template<typename Base, typename... Layers>
+class Scene final : public CompiledScene {
+public:
+    static constexpr size_t layerCount = sizeof...(Layers);
+
+    void attach(int ledCount, ScratchAllocator& scratch) override {
+        animation.Base::attach(ledCount, scratch);
+        each([&](auto& layer) { callAttach(layer, ledCount, scratch); });
+    }
+
+    void drawAnimation(CRGB* leds, int count, const AudioFeatures& audio, const FrameContext& frame) override {
+        animation.Base::update(leds, count, audio, frame);
+    }
+
+    // Same stepping as LayerManager::updateLayers at a layer speed of 1
+    void updateLayers(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame) override {
+        stepCredit += frame.steps * frame.speed;
+        while (stepCredit >= 0.5f) {
+            stepCredit -= 1.0f;
+            each([&](auto& layer) { callUpdate(layer, audio, history, frame); });
+        }
+    }
+
+    void renderLayers(CRGB* leds, int count) override {
+        renderAll(leds, count, std::index_sequence_for<Layers...>{});
+    }
+
+    void dispatchEvent(const AudioEvent& event) override {
+        const EventMask bit = eventBit(event.type);
+        each([&](auto& layer) { callEvent(layer, event, bit); });
+    }
+
+    int layerNames(const char** out, int max) const override {
+        int n = 0;
+        std::apply([&](const Layers&... layer) {
+            ((n < max ? (void)(out[n++] = layer.Layers::getName()) : (void)0), ...);
+        }, layers);
+        return n;
+    }
+
+private:
+    Base animation;
+    std::tuple<Layers...> layers;
+    float stepCredit = 0.0f;
+
+    template<typename Fn>
+    void each(Fn&& fn) {
+        std::apply([&](Layers&... layer) { (fn(layer), ...); }, layers);
+    }
+
+    // Qualified calls, so none of these dispatch through the vtable
+    template<typename L>
+    static void callAttach(L& layer, int ledCount, ScratchAllocator& scratch) { layer.L::attach(ledCount, scratch); }
+    template<typename L>
+    static void callUpdate(L& layer, const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame) {
+        if (!layer.L::dormant()) layer.L::update(audio, history, frame);
+    }
+
+    template<typename L>
+    static void callEvent(L& layer, const AudioEvent& event, EventMask bit) {
+        if (layer.L::wakeEvents() & bit) layer.L::onEvent(event);
+    }
+
+    template<size_t... I>
+    void renderAll(CRGB* leds, int count, std::index_sequence<I...>) {
+        if constexpr (layerCount > 0) {
+            PixelSpan spans[layerCount][VisualLayer::maxSpans];
+            int spanCount[layerCount] = { spansOf(std::get<I>(layers), count, spans[I])... };
+            (renderWhole(std::get<I>(layers), spanCount[I], leds, count), ...);
+            for (int begin = 0; begin < count; begin += LAYER_CHUNK_PIXELS) {
+                int end = begin + LAYER_CHUNK_PIXELS < count ? begin + LAYER_CHUNK_PIXELS : count;
+                (renderChunk(std::get<I>(layers), spans[I], spanCount[I], leds, begin, end, count), ...);
+            }
+        }
+    }
+
+    // Dormant layers draw nothing
+    template<typename L>
+    static int spansOf(const L& layer, int count, PixelSpan* out) {
+        return layer.L::dormant() ? 0 : layer.L::spans(count, out);
+    }
+
+    template<typename L>
+    static void renderWhole(L& layer, int spanCount, CRGB* leds, int count) {
+        if (spanCount > 0 && !layer.L::fusable()) layer.L::render(leds, count);
+    }
+
+    template<typename L>
+    static void renderChunk(L& layer, const PixelSpan* spans, int spanCount, CRGB* leds, int begin, int end, int count) {
+        if (!layer.L::fusable()) return;
+        for (int s = 0; s < spanCount; ++s) {
+            int from = spans[s].begin > begin ? spans[s].begin : begin;
+            int to = spans[s].end < end ? spans[s].end : end;
+            if (from < to) layer.L::renderChunk(leds + from, from, to - from, count);
+        }
+    }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include "../scenes/CompiledScene.h"
+#include "../scenes/MoodHistory.h"
+#include "../animations/AnimationCatalog.h"
+#include "../animations/VisualLayers.h"
+
+struct CompiledSceneMeta {
+    const char* name;
+    AnimationType animation;     // The scene's base animation, for the registry's tempo/energy fit
+    uint32_t moodMask;           // Bit per MoodType
+    std::function<CompiledScene*()> create;
+};
+
+template<typename S>
+CompiledSceneMeta compiledSceneEntry(const char* name, AnimationType animation, uint32_t moodMask) {
+    return { name, animation, moodMask, []() -> CompiledScene* { return new S(); } };
+}
+
+// Built-in shows with a fixed animation and layer set, drawn without virtual
+// dispatch per effect (see CompiledScene.h). SceneDefinition::compiledScene is
+// 1 + an index into this list; scene tables name them as "compiled".
+inline const std::array<CompiledSceneMeta, 4> compiledSceneCatalog = {{
+    compiledSceneEntry<Scene<NeonFlowAnimation, TrebleSparkleLayer, BassShockwaveLayer>>(
+        "Neon Storm", AnimationType::NEON_FLOW, (1u << ENERGETIC) | (1u << INTENSE)),
+    compiledSceneEntry<Scene<BassPulseStormAnimation, DominantBandFireTrailLayer, BassShockwaveLayer, BPMBeatFlashLayer>>(
+        "Bass Furnace", AnimationType::BASS_PULSE_STORM, 1u << INTENSE),
+    compiledSceneEntry<Scene<PsychedelicTunnelAnimation, BPMWavePulseLayer, CentroidGlowWipeLayer>>(
+        "Tunnel Tide", AnimationType::PSYCHEDELIC_TUNNEL, 1u << FLOATY),
+    compiledSceneEntry<Scene<AlienBreathAnimation, MoodMemoryArcLayer>>(
+        "Slow Breath", AnimationType::ALIEN_BREATH, 1u << CALM),
+}};
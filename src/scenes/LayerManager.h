@@ -1,12 +1,32 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <string.h>
 #include <FastLED.h>
 
 #include "LayerTypes.h"
+#include "LayerPool.h"
+#include "QualityGovernor.h"
+#include "SceneRegistry.h"
 #include "../audio/AudioFeatures.h"
 #include "../audio/AudioSnapshot.h"
 #include "../animations/VisualLayer.h"
+#include "../animations/LayerCatalog.h"
+#include "../animations/LevelOfDetail.h"
+#include "../utils/ProfileClock.h"
+
+// Output cache hits of one layer class, keyed by getName()
+struct LayerCacheStats {
+    const char* name = nullptr;
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+    float hitRate() const {
+        uint32_t total = hits + misses;
+        return total ? (float)hits / total : 0.0f;
+    }
+};
 
 class LayerManager {
 public:
@@ -16,6 +36,25 @@ public:
         unsigned long duration = 0;
         LayerType type;
         bool active = true;
+        uint8_t opacity = 255;
+        LayerBlend blend = LayerBlend::ADD;
+        float speed = 1.0f;
+        float stepCredit = 0;
+        int16_t poolEntry = -1;       // LayerPool entry the instance came from, -1 if heap-allocated
+        uint16_t cost = 0;
+        uint8_t priority = 0;         // Governor drops low priority first
+        LayerQuality quality = LayerQuality::FULL;
+        float costUs = 0;             // EMA of update + render time per frame
+        uint32_t frameUs = 0;         // This frame's time so far
+        uint8_t lodShift = 0;         // Current level of detail (one sample per 2^shift pixels)
+        uint8_t baseLodShift = 0;     // Picked from the strip length; the governor may go coarser
+        uint8_t maxLodShift = 0;      // Coarsest the layer allows
+        uint32_t scratchFrom = 0;     // Scene scratch taken in attach(), [from, to) in the region
+        uint32_t scratchTo = 0;
+        uint32_t updates = 0;         // Update steps run; keys a decimated layer's cached output
+        uint32_t cacheKey = 0;        // renderKey() of the cached output; 0 if none
+        bool cacheUniform = false;    // Cached output is the single colour below
+        CRGB cachedColor;
 
         bool isExpired(unsigned long now) const {
             return duration > 0 && (now - startTime > duration);
@@ -26,54 +65,648 @@ private:
     std::vector<LayerInstance> layers;
     CRGB* leds = nullptr;
     int ledCount = 0;
+    ArenaRegion* scratch = nullptr;
+    LayerPool* pool = nullptr;
+    const SceneDefinition* appliedScene = nullptr;
+    CRGB* blendBuffer = nullptr;   // Layers that don't simply add render here first
+    CRGB* lodBuffer = nullptr;     // Samples of reduced-resolution layers, sized for shift 1
+
+    // Rendered output of cached layers that aren't a single colour. Slots are
+    // claimed on first use and freed when their layer is destroyed.
+    struct CacheSlot {
+        CRGB* pixels = nullptr;
+        const VisualLayer* owner = nullptr;
+    };
+    CacheSlot cacheSlots[LAYER_CACHE_SLOTS];
+    bool cacheScratchFull = false; // A slot allocation failed; don't retry every frame
+    std::vector<LayerCacheStats> cacheStats;
+    unsigned long lastSpawn[static_cast<size_t>(LayerType::COUNT)] = {};
+    uint32_t budgetRejections = 0;
+    const char* refusal = nullptr; // Why the last spawn failed, for the log
+    uint32_t skippedRenders = 0;   // Layer renders skipped for an empty span or zero opacity
+    uint32_t fusedRenders = 0;     // Layer renders done as part of a fused run
+    uint32_t dormantSkips = 0;     // Layer frames skipped while the layer was dormant
+    bool fusedRendering = LAYER_FUSED_RENDERING;
+
+    uint32_t renderBudgetUs = LAYER_RENDER_BUDGET_US;
+    uint32_t frameCounter = 0;
+    uint16_t governorHold = 0;     // Frames to wait before the next decision
+    GovernorStats governor;
+
+    // One step per decision, then hold so the EMAs can settle
+    void govern(float stackUs) {
+        if (governorHold > 0) {
+            governorHold--;
+            return;
+        }
+        if (renderBudgetUs == 0) return;
+
+        if (stackUs > renderBudgetUs) {
+            // Lowest priority first, the most expensive among equals
+            LayerInstance* victim = nullptr;
+            for (auto& l : layers) {
+                if (!l.active || !l.layer || l.quality == LayerQuality::SUSPENDED) continue;
+                if (!victim || l.priority < victim->priority ||
+                    (l.priority == victim->priority && l.costUs > victim->costUs)) {
+                    victim = &l;
+                }
+            }
+            if (!victim) return;
+            // Layers that allow it drop resolution before they drop frames
+            if (victim->quality == LayerQuality::FULL && victim->lodShift < victim->maxLodShift) {
+                victim->lodShift++;
+            } else {
+                victim->quality = victim->quality == LayerQuality::FULL ? LayerQuality::DECIMATED : LayerQuality::SUSPENDED;
+            }
+            governor.degrades++;
+            recordDecision(*victim);
+        } else if (stackUs < renderBudgetUs * LAYER_GOVERNOR_RESTORE_RATIO) {
+            // Highest priority first, only if its last known cost still fits
+            LayerInstance* candidate = nullptr;
+            for (auto& l : layers) {
+                if (!l.active || !l.layer) continue;
+                if (l.quality == LayerQuality::FULL && l.lodShift <= l.baseLodShift) continue;
+                if (!candidate || l.priority > candidate->priority) candidate = &l;
+            }
+            if (!candidate || stackUs + candidate->costUs > renderBudgetUs * LAYER_GOVERNOR_RESTORE_RATIO) return;
+            if (candidate->quality != LayerQuality::FULL) {
+                candidate->quality = candidate->quality == LayerQuality::SUSPENDED ? LayerQuality::DECIMATED : LayerQuality::FULL;
+            } else {
+                candidate->lodShift--;
+            }
+            governor.restores++;
+            recordDecision(*candidate);
+        }
+    }
+
+    void recordDecision(LayerInstance& l) {
+        l.cacheKey = 0;  // Decimated layers key their cache differently
+        governor.lastLayer = l.layer->getName();
+        governor.lastQuality = l.quality;
+        governor.lastLodShift = l.lodShift;
+        governor.lastDecisionMs = millis();
+        governorHold = LAYER_GOVERNOR_HOLD_FRAMES;
+    }
+
+    // Pooled layers go back to their class's slots, the rest to the heap. Their
+    // scene scratch goes back to the region, so layers spawned and expired
+    // within one scene don't use it up.
+    void destroy(const LayerInstance& l) {
+        for (CacheSlot& slot : cacheSlots) {
+            if (slot.owner == l.layer) slot.owner = nullptr;
+        }
+        if (scratch) scratch->releaseSceneBlock(l.scratchFrom, l.scratchTo);
+        if (l.poolEntry >= 0 && pool) pool->release(l.poolEntry, l.layer);
+        else delete l.layer;
+    }
+
+    // Spawn pool entry `index` if its cost fits the budget
+    LayerInstance* spawn(int index, unsigned long durationMs) {
+        const LayerPool::Entry& entry = pool->entries[index];
+        if (activeCost() + entry.cost > LAYER_COST_BUDGET) {
+            budgetRejections++;
+            refusal = "over LAYER_COST_BUDGET";
+            return nullptr;
+        }
+        VisualLayer* layer = pool->acquire(index);
+        if (!layer) {
+            refusal = "no free pool slot";
+            return nullptr;
+        }
+        addLayer(layer, entry.type, durationMs);
+        LayerInstance& inst = layers.back();
+        inst.poolEntry = (int16_t)index;
+        inst.cost = entry.cost;
+        lastSpawn[static_cast<size_t>(entry.type)] = inst.startTime;
+        return &inst;
+    }
 
 public:
+    // Reserved once so spawning and expiring layers doesn't reallocate
+    LayerManager() {
+        layers.reserve(LAYER_STACK_RESERVE);
+        cacheStats.reserve(layerCatalog.size());
+    }
+
     void setLEDs(CRGB* buffer, int count) {
         leds = buffer;
         ledCount = count;
     }
 
+    // Layer scratch buffers come from this region: persistent layers from the
+    // bottom, scene layers from the top (released by the strip on scene change)
+    void setScratch(ArenaRegion* region) {
+        scratch = region;
+    }
+
+    void setLayerPool(LayerPool* layerPool) {
+        pool = layerPool;
+    }
+
     void clearLayers() {
         for (auto& l : layers) {
-            delete l.layer;
+            destroy(l);
         }
         layers.clear();
+        appliedScene = nullptr;
     }
 
-    void updateLayers(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history) {
-        unsigned long now = millis();
-        for (auto& l : layers) {
-            if (l.active && l.layer) {
-                l.layer->update(audio, history);
+    // Swap in a scene's layer stack. Persistent layers survive scene changes.
+    void applySceneLayers(const SceneDefinition& scene) {
+        if (appliedScene == &scene) return;
+        appliedScene = &scene;
+
+        layers.erase(std::remove_if(layers.begin(), layers.end(),
+            [this](const LayerInstance& l) {
+                if (l.layer && l.layer->persistent) return false;
+                destroy(l);
+                return true;
+            }), layers.end());
+
+        // A scene that doesn't get all its layers looks wrong, so say which
+        for (int i = 0; i < scene.layerCount; ++i) {
+            if (!addSceneLayer(scene.layers[i])) {
+                Serial.printf("[Layers] %s: layer %d refused (%s)\n", scene.name, i, refusal);
             }
         }
+    }
+
+    // A named catalog layer, or a random pooled one of the spec's type. Scene
+    // layers last the whole scene unless the spec gives a lifetime.
+    bool addSceneLayer(const SceneLayerSpec& spec) {
+        LayerInstance* inst = nullptr;
+        refusal = "not in the pool";
+        if (pool) {
+            int index = spec.catalogIndex >= 0 ? pool->findCatalogEntry(spec.catalogIndex) : pool->pickByType(spec.type);
+            if (index >= 0) inst = spawn(index, spec.lifetimeMs);
+        } else if (spec.catalogIndex >= 0) {
+            addLayer(layerCatalog[spec.catalogIndex].create(), spec.type, spec.lifetimeMs);
+            inst = &layers.back();
+        }
+        if (!inst) return false;
+        inst->type = spec.type;
+        inst->priority = layerPriority(spec.type) + 2;
+        inst->opacity = spec.opacity;
+        inst->blend = spec.blend;
+        inst->speed = spec.speed / 100.0f;
+        return true;
+    }
+
+    // Spawn a random pooled layer of the given type for durationMs (0: the
+    // entry's default lifetime). Fails if none is registered, its class has no
+    // free slot, or it would take the layers past LAYER_COST_BUDGET.
+    bool addLayerByType(LayerType type, unsigned long durationMs = 0) {
+        if (!pool) return false;
+        int index = pool->pickByType(type);
+        if (index < 0) return false;
+        return spawn(index, durationMs ? durationMs : pool->entries[index].lifetimeMs) != nullptr;
+    }
+
+    // Summed per-pixel cost of the active layers
+    int activeCost() const {
+        int total = 0;
+        for (const auto& l : layers) {
+            if (l.active && l.layer) total += l.cost;
+        }
+        return total;
+    }
+
+    unsigned long millisSinceSpawn(LayerType type, unsigned long now) const {
+        return now - lastSpawn[static_cast<size_t>(type)];
+    }
+
+    uint32_t getBudgetRejections() const {
+        return budgetRejections;
+    }
+
+    uint32_t getSkippedRenders() const {
+        return skippedRenders;
+    }
+
+    uint32_t getFusedRenders() const {
+        return fusedRenders;
+    }
+
+    uint32_t getDormantSkips() const {
+        return dormantSkips;
+    }
+
+    // Hands an event to each layer that wakes on it. LEDStrip subscribes to the
+    // EventBus and calls this for every stack.
+    void dispatchEvent(const AudioEvent& event) {
+        const EventMask bit = eventBit(event.type);
+        for (LayerInstance& l : layers) {
+            if (l.active && l.layer && (l.layer->wakeEvents() & bit)) l.layer->onEvent(event);
+        }
+    }
+
+    // Chunked evaluation of fusable layers; off draws every layer in its own pass
+    void setFusedRendering(bool enabled) {
+        fusedRendering = enabled;
+    }
+
+    const std::vector<LayerCacheStats>& getCacheStats() const {
+        return cacheStats;
+    }
+
+    // Layer update + render time this stack may use per frame; 0 turns the governor off
+    void setRenderBudget(uint32_t us) {
+        renderBudgetUs = us;
+    }
+
+    GovernorStats getGovernorStats() const {
+        GovernorStats stats = governor;
+        for (const auto& l : layers) {
+            if (!l.active || !l.layer) continue;
+            if (l.quality == LayerQuality::DECIMATED) stats.decimatedNow++;
+            if (l.quality == LayerQuality::SUSPENDED) stats.suspendedNow++;
+            if (l.lodShift > l.baseLodShift) stats.coarsenedNow++;
+        }
+        return stats;
+    }
+
+    const std::vector<LayerInstance>& getLayers() const {
+        return layers;
+    }
+
+    int activeCount() const {
+        return std::count_if(layers.begin(), layers.end(), [](const LayerInstance& l) {
+            return l.active && l.layer;
+        });
+    }
+
+    // Layers advance in whole update steps at the reference frame rate, scaled
+    // by the global SPEED setting and each layer's own speed: at 1.0 that is
+    // one step per LED_FRAME_INTERVAL_US of frame time, so 0.5 steps every
+    // other frame and 2.0 steps twice, with no per-layer code. Credit rounds
+    // to the nearest step, so frame jitter around the reference rate doesn't
+    // make a layer skip one frame and double up on the next.
+    void updateLayers(const AudioFeatures& audio, const std::deque<AudioSnapshot>& history, const FrameContext& frame) {
+        unsigned long now = frame.nowMs;
+        const float credit = frame.steps * frame.speed;
+        for (size_t i = 0; i < layers.size(); ++i) {
+            LayerInstance& l = layers[i];
+            if (!l.active || !l.layer || l.quality == LayerQuality::SUSPENDED) continue;
+            if (l.layer->dormant()) {
+                dormantSkips++;
+                continue;
+            }
+            // Decimated layers sit out alternate frames, staggered so they don't all
+            // skip together. They keep earning credit and spend it on the next frame,
+            // so they move at the same speed with half the temporal resolution. That
+            // saves their renders; if the double step is still too much, the governor
+            // suspends them next.
+            l.stepCredit += credit * l.speed;
+            if (l.quality == LayerQuality::DECIMATED && ((frameCounter + i) & 1)) continue;
+            uint32_t start = profileMicros();
+            while (l.stepCredit >= 0.5f) {
+                l.stepCredit -= 1.0f;
+                l.layer->update(audio, history, frame);
+                l.updates++;
+            }
+            l.frameUs += profileMicros() - start;
+        }
         // Clean up expired layers
         layers.erase(std::remove_if(layers.begin(), layers.end(),
-            [now](const LayerInstance& l) {
+            [this, now](const LayerInstance& l) {
                 if (l.isExpired(now)) {
-                    delete l.layer;
+                    destroy(l);
                     return true;
                 }
                 return false;
             }), layers.end());
     }
 
+    // Also closes the frame for the governor: per-layer EMAs, then at most one decision.
+    // Consecutive fusable layers are drawn together a chunk at a time.
     void renderLayers() {
         if (!leds) return;
+        for (size_t i = 0; i < layers.size();) {
+            size_t runEnd = fusedRendering ? fusableRunEnd(i) : i;
+            if (runEnd > i) {
+                renderFused(i, runEnd);
+                i = runEnd;
+                continue;
+            }
+            LayerInstance& l = layers[i++];
+            if (!renders(l)) continue;
+            uint32_t start = profileMicros();
+            renderLayer(l);
+            l.frameUs += profileMicros() - start;
+        }
+
+        float stackUs = 0;
         for (auto& l : layers) {
-            if (l.active && l.layer) {
-                l.layer->render(leds, ledCount);
+            if (!renders(l)) {
+                l.frameUs = 0;
+                continue;
+            }
+            l.costUs = l.costUs == 0 ? l.frameUs : l.costUs * 0.9f + l.frameUs * 0.1f;
+            l.frameUs = 0;
+            stackUs += l.costUs;
+        }
+        governor.stackUs = stackUs;
+        if (stackUs > governor.peakStackUs) governor.peakStackUs = stackUs;
+        frameCounter++;
+        govern(stackUs);
+    }
+
+    // Dormant layers are left out of rendering, fused runs and the governor's total
+    static bool renders(const LayerInstance& l) {
+        return l.active && l.layer && l.quality != LayerQuality::SUSPENDED && !l.layer->dormant();
+    }
+
+    // Full-resolution, uncached layers that can draw a chunk on their own
+    static bool canFuse(const LayerInstance& l) {
+        return l.layer->fusable() && l.lodShift == 0 && l.quality == LayerQuality::FULL && l.layer->renderKey() == 0;
+    }
+
+    // End of the run of fusable layers starting at `first`, or `first` if fewer
+    // than two would take part. Layers that don't render this frame don't break a run.
+    size_t fusableRunEnd(size_t first) const {
+        size_t end = first;
+        int members = 0;
+        while (end < layers.size()) {
+            const LayerInstance& l = layers[end];
+            if (renders(l)) {
+                if (!canFuse(l) || members == LAYER_FUSED_MAX) break;
+                members++;
+            }
+            end++;
+        }
+        return members >= 2 ? end : first;
+    }
+
+    // Every layer of the run, in stack order, over one LAYER_CHUNK_PIXELS chunk
+    // before moving to the next. The run's time is shared out by catalog cost.
+    void renderFused(size_t first, size_t last) {
+        struct Member {
+            LayerInstance* inst;
+            PixelSpan spans[VisualLayer::maxSpans];
+            int spanCount;
+        };
+        Member run[LAYER_FUSED_MAX];
+        int members = 0;
+        uint32_t totalCost = 0;
+        for (size_t i = first; i < last; ++i) {
+            LayerInstance& l = layers[i];
+            if (!renders(l)) continue;
+            Member& m = run[members];
+            m.inst = &l;
+            m.spanCount = l.opacity == 0 ? 0 : l.layer->spans(ledCount, m.spans);
+            if (m.spanCount == 0) {
+                skippedRenders++;
+                continue;
+            }
+            totalCost += l.cost ? l.cost : 1;
+            members++;
+        }
+        if (members == 0) return;
+
+        uint32_t start = profileMicros();
+        CRGB chunk[LAYER_CHUNK_PIXELS];
+        for (int begin = 0; begin < ledCount; begin += LAYER_CHUNK_PIXELS) {
+            int end = begin + LAYER_CHUNK_PIXELS < ledCount ? begin + LAYER_CHUNK_PIXELS : ledCount;
+            for (int m = 0; m < members; ++m) {
+                LayerInstance& l = *run[m].inst;
+                for (int s = 0; s < run[m].spanCount; ++s) {
+                    int from = max(run[m].spans[s].begin, begin);
+                    int to = min(run[m].spans[s].end, end);
+                    if (from >= to) continue;
+                    if (l.blend == LayerBlend::ADD && l.opacity == 255) {
+                        l.layer->renderChunk(leds + from, from, to - from, ledCount);
+                    } else {
+                        fill_solid(chunk, to - from, CRGB::Black);
+                        l.layer->renderChunk(chunk, from, to - from, ledCount);
+                        blendLayer(l.blend, l.opacity, chunk, leds + from, to - from);
+                    }
+                }
+            }
+        }
+        uint32_t elapsed = profileMicros() - start;
+        for (int m = 0; m < members; ++m) {
+            uint32_t cost = run[m].inst->cost ? run[m].inst->cost : 1;
+            run[m].inst->frameUs += elapsed * cost / totalCost;
+        }
+        fusedRenders += members;
+    }
+
+    // Only the spans the layer reports are cleared and blended; a layer with
+    // nothing to draw, or drawn at zero opacity, isn't rendered at all
+    void renderLayer(LayerInstance& l) {
+        PixelSpan spans[VisualLayer::maxSpans];
+        int spanCount = l.opacity == 0 ? 0 : l.layer->spans(ledCount, spans);
+        if (spanCount == 0) {
+            skippedRenders++;
+            return;
+        }
+        uint32_t key = l.layer->renderKey();
+        bool keyed = key != 0;
+        // A decimated layer's output only changes when it updates
+        if (!keyed && l.quality == LayerQuality::DECIMATED) key = l.updates + 1;
+        if (key != 0 && renderCached(l, key, spans, spanCount, keyed)) return;
+        if (l.lodShift > 0) {
+            renderReduced(l);
+            return;
+        }
+        if (l.blend == LayerBlend::ADD && l.opacity == 255) {
+            l.layer->render(leds, ledCount);
+            return;
+        }
+        // Render onto black to get the layer on its own, then combine.
+        // Without room for the buffer the layer falls back to plain ADD.
+        if (!ensureBlendBuffer()) {
+            l.blend = LayerBlend::ADD;
+            l.opacity = 255;
+            l.layer->render(leds, ledCount);
+            return;
+        }
+        for (int s = 0; s < spanCount; ++s) fill_solid(blendBuffer + spans[s].begin, spans[s].length(), CRGB::Black);
+        l.layer->render(blendBuffer, ledCount);
+        for (int s = 0; s < spanCount; ++s) {
+            blendLayer(l.blend, l.opacity, blendBuffer + spans[s].begin, leds + spans[s].begin, spans[s].length());
+        }
+    }
+
+    // Re-blend the layer's last output while its key is unchanged. Single
+    // colour layers keep just the colour; the rest need a cache slot, and
+    // render normally (returning false) while none is free. Only the layer's
+    // own renderKey() counts towards the cache stats.
+    bool renderCached(LayerInstance& l, uint32_t key, const PixelSpan* spans, int spanCount, bool keyed) {
+        CacheSlot* slot = nullptr;
+        for (CacheSlot& s : cacheSlots) {
+            if (s.owner == l.layer) slot = &s;
+        }
+        bool hit = l.cacheKey == key && (l.cacheUniform || slot);
+        if (!hit) {
+            l.cacheKey = 0;
+            l.cacheUniform = l.layer->uniformColor(l.cachedColor);
+            if (!l.cacheUniform) {
+                if (!slot) slot = claimCacheSlot(l.layer);
+                if (!slot) return false;
+                // At the layer's level of detail, like an uncached render
+                if (l.lodShift > 0 && sampleReduced(l)) {
+                    lodUpsampleCopy(lodBuffer, l.lodShift, slot->pixels, ledCount);
+                } else {
+                    fill_solid(slot->pixels, ledCount, CRGB::Black);
+                    l.layer->render(slot->pixels, ledCount);
+                }
+            }
+            l.cacheKey = key;
+        }
+        if (keyed) recordCache(l.layer->getName(), hit);
+
+        for (int s = 0; s < spanCount; ++s) {
+            CRGB* dst = leds + spans[s].begin;
+            if (l.cacheUniform) blendUniform(l.blend, l.opacity, l.cachedColor, dst, spans[s].length());
+            else blendLayer(l.blend, l.opacity, slot->pixels + spans[s].begin, dst, spans[s].length());
+        }
+        return true;
+    }
+
+    CacheSlot* claimCacheSlot(const VisualLayer* owner) {
+        for (CacheSlot& slot : cacheSlots) {
+            if (slot.owner) continue;
+            if (!slot.pixels) {
+                // Only from headroom the region has never needed, with a quarter
+                // to spare, so a cache never starves a layer's own buffers
+                size_t bytes = LedArena::alignUp(ledCount * sizeof(CRGB));
+                if (cacheScratchFull || !scratch ||
+                    scratch->capacity() - scratch->peakUsed() < bytes + scratch->capacity() / 4) return nullptr;
+                ScratchAllocator allocator(scratch, false);
+                slot.pixels = allocator.allocate<CRGB>(ledCount);
+                cacheScratchFull = slot.pixels == nullptr;
+                if (!slot.pixels) return nullptr;
+            }
+            slot.owner = owner;
+            return &slot;
+        }
+        return nullptr;
+    }
+
+    void recordCache(const char* name, bool hit) {
+        LayerCacheStats* stats = nullptr;
+        for (auto& entry : cacheStats) {
+            if (entry.name == name || !strcmp(entry.name, name)) {
+                stats = &entry;
+                break;
+            }
+        }
+        if (!stats) {
+            cacheStats.emplace_back();
+            stats = &cacheStats.back();
+            stats->name = name;
+        }
+        if (hit) stats->hits++;
+        else stats->misses++;
+    }
+
+    // Renders the layer's samples at its LOD into lodBuffer. Without room for
+    // the buffer every layer goes back to full resolution and this returns false.
+    bool sampleReduced(LayerInstance& l) {
+        if (!lodBuffer) {
+            ScratchAllocator allocator(scratch, false);
+            lodBuffer = allocator.allocate<CRGB>(lodSamples(ledCount, 1));
+            if (!lodBuffer) {
+                for (auto& other : layers) other.lodShift = other.baseLodShift = other.maxLodShift = 0;
+                return false;
+            }
+        }
+        int samples = lodSamples(ledCount, l.lodShift);
+        fill_solid(lodBuffer, samples, CRGB::Black);
+        l.layer->renderSampled(lodBuffer, samples, ledCount, 1 << l.lodShift);
+        return true;
+    }
+
+    // Samples at the layer's LOD, interpolated up into the strip or, for
+    // blended layers, into the blend buffer first. Falls back to full
+    // resolution if there is no room for the sample buffer.
+    void renderReduced(LayerInstance& l) {
+        if (!sampleReduced(l)) {
+            renderLayer(l);
+            return;
+        }
+        if (l.blend == LayerBlend::ADD && l.opacity == 255) {
+            lodUpsampleAdd(lodBuffer, l.lodShift, leds, ledCount);
+        } else if (ensureBlendBuffer()) {
+            lodUpsampleCopy(lodBuffer, l.lodShift, blendBuffer, ledCount);
+            blendLayer(l.blend, l.opacity, blendBuffer, leds, ledCount);
+        } else {
+            l.blend = LayerBlend::ADD;
+            l.opacity = 255;
+            lodUpsampleAdd(lodBuffer, l.lodShift, leds, ledCount);
+        }
+    }
+
+    bool ensureBlendBuffer() {
+        if (!blendBuffer) {
+            ScratchAllocator allocator(scratch, false);
+            blendBuffer = allocator.allocate<CRGB>(ledCount);
+        }
+        return blendBuffer != nullptr;
+    }
+
+    static void blendPixel(LayerBlend mode, uint8_t opacity, const CRGB& src, CRGB& dst) {
+        if (!(src.r | src.g | src.b)) return;
+        CRGB s = src;
+        s.nscale8(opacity);
+        switch (mode) {
+            case LayerBlend::SCREEN:
+                for (int c = 0; c < 3; ++c) dst[c] = dst[c] + s[c] - scale8(dst[c], s[c]);
+                break;
+            case LayerBlend::LIGHTEN:
+                for (int c = 0; c < 3; ++c) dst[c] = max(dst[c], s[c]);
+                break;
+            case LayerBlend::ALPHA: {
+                // The layer is premultiplied by its own brightness; cover by that much
+                uint8_t alpha = scale8(max(src.r, max(src.g, src.b)), opacity);
+                dst.nscale8(255 - alpha);
+                dst += s;
+                break;
             }
+            case LayerBlend::ADD:
+            default:
+                dst += s;
+                break;
         }
     }
 
+    static void blendLayer(LayerBlend mode, uint8_t opacity, const CRGB* src, CRGB* dst, int count) {
+        for (int i = 0; i < count; ++i) blendPixel(mode, opacity, src[i], dst[i]);
+    }
+
+    static void blendUniform(LayerBlend mode, uint8_t opacity, const CRGB& color, CRGB* dst, int count) {
+        if (mode == LayerBlend::ADD) {
+            CRGB s = color;
+            s.nscale8(opacity);
+            for (int i = 0; i < count; ++i) dst[i] += s;
+            return;
+        }
+        for (int i = 0; i < count; ++i) blendPixel(mode, opacity, color, dst[i]);
+    }
+
     void addLayer(VisualLayer* layer, LayerType type = LayerType::OVERLAY, unsigned long durationMs = 0) {
         LayerInstance inst;
+        if (layer) {
+            size_t mark = scratch ? scratch->sceneMark() : 0;
+            ScratchAllocator allocator(scratch, !layer->persistent);
+            layer->attach(ledCount, allocator);
+            if (scratch && !layer->persistent) {
+                inst.scratchFrom = (uint32_t)scratch->sceneMark();
+                inst.scratchTo = (uint32_t)mark;
+            }
+        }
         inst.layer = layer;
         inst.startTime = millis();
         inst.duration = durationMs;
         inst.type = type;
         inst.active = true;
+        inst.priority = layerPriority(type) + (layer && layer->persistent ? 2 : 0);
+        if (layer) {
+            uint8_t maxShift = layer->maxLodShift();
+            inst.maxLodShift = maxShift < LOD_MAX_SHIFT ? maxShift : LOD_MAX_SHIFT;
+            inst.baseLodShift = inst.lodShift = lodShiftFor(inst.maxLodShift, ledCount);
+        }
         layers.push_back(inst);
     }
 
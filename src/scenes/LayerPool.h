@@ -3,12 +3,23 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <stdlib.h>
 
+#include "../config/Config.h"
 #include "../scenes/LayerTypes.h"
 #include "../animations/VisualLayer.h"
+#include "../animations/LayerCatalog.h"
+#include "../utils/AliasTable.h"
+#include "../utils/SpinLock.h"
 
 // This defines a reusable pool of known layer templates
 // SceneDirector can instantiate layers by type or by name/tag/etc.
+//
+// Catalog layers get a fixed number of preallocated slots per class: spawning
+// constructs in a free slot and expiry destroys in place, and LayerManager
+// reserves its stack up front, so layers come and go without touching the heap
+// (up to LAYER_STACK_RESERVE per stack). Entries added with a plain factory use
+// new/delete.
 class LayerPool {
 public:
     // A single layer template with metadata
@@ -16,28 +27,169 @@ public:
         LayerType type;
         std::function<VisualLayer*()> factory;
         String name;
+        float weight = 1.0f;
+        uint16_t cost = 0;            // Per-pixel render cost, same units as LayerMeta::cost
+        uint32_t lifetimeMs = 0;      // Default lifetime when spawned by type
+        int16_t catalogIndex = -1;
+    };
+
+    struct Stats {
+        uint32_t spawned = 0;
+        uint32_t recycled = 0;        // Spawns that reused a slot freed by an expired layer
+        uint32_t exhausted = 0;       // Spawns refused because every slot of the class was taken
+        uint16_t inUse = 0;
+        uint16_t slots = 0;
     };
 
     std::vector<Entry> entries;
 
-    void registerLayer(LayerType type, std::function<VisualLayer*()> factory, const String& name) {
-        entries.push_back({type, factory, name});
+    LayerPool() = default;
+    LayerPool(const LayerPool&) = delete;
+    LayerPool& operator=(const LayerPool&) = delete;
+    ~LayerPool() { clear(); }
+
+    void registerLayer(LayerType type, std::function<VisualLayer*()> factory, const String& name, float weight = 1.0f) {
+        Entry entry;
+        entry.type = type;
+        entry.factory = factory;
+        entry.name = name;
+        entry.weight = weight;
+        entries.push_back(entry);
+        slabs.emplace_back();
+        rebuildType(type);
     }
 
-    std::vector<Entry> getByType(LayerType type) const {
-        std::vector<Entry> result;
-        for (const auto& e : entries) {
-            if (e.type == type) result.push_back(e);
+    // Slots of a class are tracked in one 32-bit mask
+    static constexpr uint8_t maxSlotsPerClass = 32;
+
+    // Every layerCatalog class, each with slotsPerClass preallocated instances
+    void registerCatalog(uint8_t slotsPerClass = LAYER_POOL_SLOTS_PER_STRIP) {
+        if (slotsPerClass > maxSlotsPerClass) slotsPerClass = maxSlotsPerClass;
+        for (size_t i = 0; i < layerCatalog.size(); ++i) {
+            const LayerMeta& meta = layerCatalog[i];
+            Entry entry;
+            entry.type = meta.type;
+            entry.factory = meta.create;
+            entry.name = meta.name;
+            entry.cost = meta.cost;
+            entry.lifetimeMs = meta.lifetimeMs;
+            entry.catalogIndex = (int16_t)i;
+            entries.push_back(entry);
+
+            Slab slab;
+            slab.stride = (meta.size + meta.align - 1) / meta.align * meta.align;
+            slab.storage = static_cast<uint8_t*>(malloc(slab.stride * slotsPerClass));
+            slab.capacity = slab.storage ? slotsPerClass : 0;
+            slab.construct = meta.construct;
+            slabs.push_back(slab);
+            stats.slots += slab.capacity;
         }
-        return result;
+        for (int t = 0; t < (int)LayerType::COUNT; ++t) rebuildType((LayerType)t);
     }
 
-    Entry getRandomByType(LayerType type) const {
-        auto list = getByType(type);
-        if (list.empty()) return {LayerType::BASE, nullptr, "None"};
-        return list[random(list.size())];
+    // Entry indices of one type, built at registration
+    const std::vector<uint16_t>& getByType(LayerType type) const {
+        return byType[static_cast<size_t>(type)].ids();
     }
 
-    void clear() { entries.clear(); }
-};
+    // Weighted pick among the entries of a type; -1 if none is registered
+    int pickByType(LayerType type) const {
+        const AliasTable& table = byType[static_cast<size_t>(type)];
+        return table.empty() ? -1 : table.pick();
+    }
+
+    const Entry* getRandomByType(LayerType type) const {
+        int index = pickByType(type);
+        return index < 0 ? nullptr : &entries[index];
+    }
+
+    int findCatalogEntry(int catalogIndex) const {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].catalogIndex == catalogIndex) return (int)i;
+        }
+        return -1;
+    }
+
+    // A fresh instance of entry `index`, or nullptr if its class has no free slot.
+    // Safe from any render lane: only the slot bookkeeping is locked, and the
+    // constructor runs after the slot is claimed.
+    VisualLayer* acquire(int index) {
+        Slab& slab = slabs[index];
+        if (!slab.construct) {
+            {
+                SpinLockGuard guard(lock);
+                stats.spawned++;
+            }
+            return entries[index].factory();
+        }
+        uint8_t slot = slab.capacity;
+        {
+            SpinLockGuard guard(lock);
+            for (uint8_t i = 0; i < slab.capacity; ++i) {
+                uint32_t bit = 1u << i;
+                if (slab.used & bit) continue;
+                slab.used |= bit;
+                if (slab.everUsed & bit) stats.recycled++;
+                slab.everUsed |= bit;
+                stats.spawned++;
+                stats.inUse++;
+                slot = i;
+                break;
+            }
+            if (slot == slab.capacity) stats.exhausted++;
+        }
+        return slot < slab.capacity ? slab.construct(slab.storage + slot * slab.stride) : nullptr;
+    }
+
+    // Layers expire inside LayerManager::updateLayers, so this too runs on any lane
+    void release(int index, VisualLayer* layer) {
+        if (!layer) return;
+        Slab& slab = slabs[index];
+        uint8_t* at = reinterpret_cast<uint8_t*>(layer);
+        if (!slab.construct || at < slab.storage || at >= slab.storage + slab.stride * slab.capacity) {
+            delete layer;
+            return;
+        }
+        layer->~VisualLayer();
+        SpinLockGuard guard(lock);
+        slab.used &= ~(1u << ((at - slab.storage) / slab.stride));
+        stats.inUse--;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+    // Only valid once no instance from the pool is alive
+    void clear() {
+        for (Slab& slab : slabs) free(slab.storage);
+        slabs.clear();
+        entries.clear();
+        for (auto& table : byType) table = AliasTable();
+        stats = Stats();
+    }
+
+private:
+    struct Slab {
+        uint8_t* storage = nullptr;
+        size_t stride = 0;
+        uint8_t capacity = 0;
+        uint32_t used = 0;
+        uint32_t everUsed = 0;
+        VisualLayer* (*construct)(void* at) = nullptr;
+    };
+
+    std::vector<Slab> slabs;
+    SpinLock lock;   // Slot masks and stats; strips render on several lanes
+    AliasTable byType[static_cast<size_t>(LayerType::COUNT)];
+    Stats stats;
 
+    void rebuildType(LayerType type) {
+        std::vector<uint16_t> ids;
+        std::vector<float> weights;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].type != type) continue;
+            ids.push_back((uint16_t)i);
+            weights.push_back(entries[i].weight);
+        }
+        byType[static_cast<size_t>(type)].build(ids, weights);
+    }
+};
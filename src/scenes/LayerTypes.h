@@ -1,6 +1,8 @@
 #pragma once
 
-enum class LayerType {
+#include <stdint.h>
+
+enum class LayerType : uint8_t {
     BASE,            // Main background or scene-defining visuals
     BACKGROUND,      // Ambient fills, fog, slow ripples
     OVERLAY,         // Rings, trails, motion streaks
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include "LayerTypes.h"
+
+// How much of its work a layer is allowed to do while the stack is over budget
+enum class LayerQuality : uint8_t {
+    FULL,        // Update and render every frame
+    DECIMATED,   // Update every other frame with the steps of both; in between re-blend the last output if a cache slot is free
+    SUSPENDED,   // Neither; kept alive so it can come back where it left off
+};
+
+inline const char* layerQualityToString(LayerQuality quality) {
+    switch (quality) {
+        case LayerQuality::FULL: return "full";
+        case LayerQuality::DECIMATED: return "decimated";
+        case LayerQuality::SUSPENDED: return "suspended";
+        default: return "unknown";
+    }
+}
+
+// Which layers the governor gives up first: short-lived accents before the
+// layers a scene is built on. Scene and persistent layers get a bonus on top.
+inline uint8_t layerPriority(LayerType type) {
+    switch (type) {
+        case LayerType::BASE: return 8;
+        case LayerType::TRANSITION: return 7;
+        case LayerType::BACKGROUND: return 6;
+        case LayerType::MOOD_ARC: return 5;
+        case LayerType::OVERLAY: return 4;
+        case LayerType::ENERGY: return 3;
+        case LayerType::REACTIVE: return 2;
+        case LayerType::HIGHLIGHT: return 1;
+        default: return 0;
+    }
+}
+
+// Governor decisions and measured stack cost, summed over strips by LEDStripController
+struct GovernorStats {
+    uint32_t degrades = 0;          // Steps down (coarser LOD -> decimated -> suspended)
+    uint32_t restores = 0;          // Steps back up
+    uint16_t decimatedNow = 0;
+    uint16_t suspendedNow = 0;
+    uint16_t coarsenedNow = 0;      // Layers below their strip-length level of detail
+    float stackUs = 0.0f;           // EMA of layer update + render time per frame
+    float peakStackUs = 0.0f;
+
+    // Most recent decision, for the debug print
+    const char* lastLayer = nullptr;
+    LayerQuality lastQuality = LayerQuality::FULL;
+    uint8_t lastLodShift = 0;
+    unsigned long lastDecisionMs = 0;
+
+    void add(const GovernorStats& o) {
+        degrades += o.degrades;
+        restores += o.restores;
+        decimatedNow += o.decimatedNow;
+        suspendedNow += o.suspendedNow;
+        coarsenedNow += o.coarsenedNow;
+        stackUs += o.stackUs;
+        if (o.peakStackUs > peakStackUs) peakStackUs = o.peakStackUs;
+        if (o.lastLayer && o.lastDecisionMs >= lastDecisionMs) {
+            lastLayer = o.lastLayer;
+            lastQuality = o.lastQuality;
+            lastLodShift = o.lastLodShift;
+            lastDecisionMs = o.lastDecisionMs;
+        }
+    }
+};
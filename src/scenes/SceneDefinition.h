@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "../config/Config.h"
+#include "../scenes/LayerTypes.h"
+#include "../scenes/MoodHistory.h"
+#include "../animations/AnimationCatalog.h"
+
+// How a scene layer is combined with what is already in the strip buffer
+enum class LayerBlend : uint8_t {
+    ADD,        // Layers draw with += straight into the buffer (the default)
+    SCREEN,     // Brightens without clipping to white as quickly as ADD
+    LIGHTEN,    // Per-channel maximum
+    ALPHA,      // Covers the buffer where the layer is lit
+    COUNT
+};
+
+inline const char* layerBlendToString(LayerBlend blend) {
+    switch (blend) {
+        case LayerBlend::ADD: return "add";
+        case LayerBlend::SCREEN: return "screen";
+        case LayerBlend::LIGHTEN: return "lighten";
+        case LayerBlend::ALPHA: return "alpha";
+        default: return "unknown";
+    }
+}
+
+// One entry of a scene's layer stack
+struct SceneLayerSpec {
+    LayerType type = LayerType::OVERLAY;
+    uint8_t opacity = 255;
+    LayerBlend blend = LayerBlend::ADD;
+    uint8_t speed = 100;                 // Percent of the strip's layer update rate
+    int16_t catalogIndex = -1;           // Index into layerCatalog; -1 picks a random pooled layer of `type`
+    uint8_t reserved[2] = {};
+    uint32_t lifetimeMs = 0;             // 0 keeps the layer for the whole scene
+};
+
+// A scene is plain data with fixed-width fields and no pointers, so a table of
+// them can be written by the host tool and read back on device with one copy
+// (see SceneTable.h). Field order keeps the layout identical on ESP32 and host.
+struct SceneDefinition {
+    char name[SCENE_NAME_LENGTH] = {};
+    AnimationType baseAnimation = AnimationType::PSYCHEDELIC_TUNNEL;
+    uint32_t moodMask = 0;               // Bit per MoodType
+    uint32_t minDurationMs = 0;          // 0 derives the duration from the music
+    uint32_t idealDurationMs = 0;
+    uint8_t layerCount = 0;
+    uint8_t weight = 100;                // Relative chance among scenes of the same mood; 0 never auto-picks
+    uint8_t compiledScene = 0;           // 1 + index into compiledSceneCatalog, drawn instead of baseAnimation; 0 for none
+    uint8_t reserved = 0;
+    SceneLayerSpec layers[SCENE_MAX_LAYERS];  // Drawn through LayerManager, on top of a compiled scene's own layers
+
+    bool supportsMood(MoodType mood) const {
+        return moodMask & (1u << mood);
+    }
+
+    void setName(const char* text) {
+        strncpy(name, text, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+    }
+
+    bool addLayer(const SceneLayerSpec& spec) {
+        if (layerCount >= SCENE_MAX_LAYERS) return false;
+        layers[layerCount++] = spec;
+        return true;
+    }
+
+    bool addLayer(LayerType type) {
+        SceneLayerSpec spec;
+        spec.type = type;
+        return addLayer(spec);
+    }
+};
+
+static_assert(std::is_trivially_copyable<SceneDefinition>::value, "scene tables are copied as raw bytes");
+static_assert(sizeof(SceneLayerSpec) == 12, "SceneLayerSpec layout changed; bump SceneTable::version");
@@ -3,6 +3,7 @@
 #include "../scenes/MoodHistory.h"
 #include "../scenes/SceneRegistry.h"
 #include "../scenes/SceneState.h"
+#include "../scenes/LayerManager.h"
 
 
 struct SceneDefinition;
@@ -31,7 +32,7 @@ public:
 
     void begin() {
         if (!state) return;
-        const SceneDefinition& initial = registry.pickSceneByMood(*state, mood.getCurrentSnapshot());
+        const SceneDefinition& initial = registry.pickSceneByMood(*state, mood.getCurrentMood(), mood.getCurrentSnapshot());
         state->beginScene(&initial, mood.getCurrentSnapshot());
     }
 
@@ -48,32 +49,26 @@ public:
         if (!state) return;
         mood.update(features);
         const MoodSnapshot& moodNow = mood.getCurrentSnapshot();
-        const MoodSnapshot& predictedMood = mood.getPredictedNextMood();
 
         if (state->shouldTransition(moodNow)) {
-            const SceneDefinition& nextScene = registry.pickSceneByMood(*state, predictedMood);
-            state->beginScene(&nextScene, convertToMoodInfo(moodNow));
+            const SceneDefinition& nextScene = registry.pickSceneByMood(*state, mood.getPredictedNextMood(), moodNow);
+            state->beginScene(&nextScene, moodNow);
         }
     }
 
-    void maybeInjectReactiveLayer(LayerManager& layerManager, const AudioFeatures& audio, unsigned long now) {
-        static unsigned long lastBeatEffect = 0;
-        static unsigned long lastEnergyEffect = 0;
-        static const int maxActiveLayers = 4;
-
-        if (layerManager.activeCount() >= maxActiveLayers) return;
-
-        if (audio.beatDetected && now - lastBeatEffect > 800) {
+    // Call once per analysis result for each strip's scene layers, with the
+    // events the result fired (EventBus::fired()). What can run at once is
+    // limited by LayerManager's cost budget, not a layer count.
+    void maybeInjectReactiveLayer(LayerManager& layerManager, const AudioFeatures& audio, EventMask events, unsigned long now) {
+        if ((events & eventBit(AudioEventType::BEAT)) && layerManager.millisSinceSpawn(LayerType::REACTIVE, now) > 800) {
             if (random(100) < 70) {
                 layerManager.addLayerByType(LayerType::REACTIVE);
-                lastBeatEffect = now;
             }
         }
 
-        if (audio.energy > 0.6f && now - lastEnergyEffect > 1500) {
+        if (audio.energy > 0.6f && layerManager.millisSinceSpawn(LayerType::OVERLAY, now) > 1500) {
             if (random(100) < 40) {
                 layerManager.addLayerByType(LayerType::OVERLAY);
-                lastEnergyEffect = now;
             }
         }
 
@@ -83,14 +78,13 @@ public:
     }
 
     const SceneDefinition* getCurrentSceneForStrip(int index) const {
-        return state.activeScene;
+        return state ? state->activeScene : nullptr;
     }
 
     void forceNextScene() {
         if (!state) return;
-        const MoodSnapshot& currentMood = mood.getCurrentSnapshot();
-        const SceneDefinition& next = registry.pickSceneByMood(*state, currentMood);
-        state->beginScene(&next, currentMood);
+        const SceneDefinition& next = registry.pickSceneByMood(*state, mood.getCurrentMood(), mood.getCurrentSnapshot());
+        state->beginScene(&next, mood.getCurrentSnapshot());
     }
 
     const SceneDefinition* getActiveScene() const {
@@ -2,54 +2,141 @@
 
 #include <vector>
 #include <algorithm> 
-#include "../scenes/SceneState.h"
 #include "../scenes/LayerTypes.h"
 #include "../scenes/MoodHistory.h"
+#include "../scenes/SceneDefinition.h"
+#include "../scenes/SceneTable.h"
+#include "../scenes/CompiledSceneCatalog.h"
 #include "../animations/AnimationCatalog.h"
+#include "../core/Debug.h"
+#include "../utils/AliasTable.h"
 
-struct SceneDefinition {
-    AnimationType baseAnimation;
-    std::vector<LayerType> layerTypes;
-    std::vector<MoodType> preferredMoods;
-    String name;
-    const SceneDefinition* activeScene = nullptr;
-
-    bool supportsMood(MoodType mood) const {
-        return std::find(preferredMoods.begin(), preferredMoods.end(), mood) != preferredMoods.end();
-    }
-};
+struct SceneState;
 
 class SceneRegistry {
 private:
     std::vector<SceneDefinition> scenes;
 
+    // Scenes per mood, weighted by SceneDefinition::weight; [UNKNOWN] holds every scene
+    AliasTable byMood[UNKNOWN + 1];
+
+    // Most recent picks, newest last, for avoiding repeats
+    uint16_t recent[SCENE_HISTORY_LENGTH] = {};
+    uint8_t recentCount = 0;
+
+    bool playedRecently(uint16_t id, size_t window) const {
+        for (size_t i = 0; i < window && i < recentCount; ++i) {
+            if (recent[recentCount - 1 - i] == id) return true;
+        }
+        return false;
+    }
+
+    void remember(uint16_t id) {
+        if (recentCount == SCENE_HISTORY_LENGTH) {
+            memmove(recent, recent + 1, (SCENE_HISTORY_LENGTH - 1) * sizeof(recent[0]));
+            recentCount--;
+        }
+        recent[recentCount++] = id;
+    }
+
+    // 0.25..1: how well the scene's animation suits the music's tempo and energy
+    static float fit(const SceneDefinition& scene, const MoodSnapshot& now) {
+        const AnimationMeta& meta = animationCatalog[static_cast<size_t>(scene.baseAnimation)];
+        float tempo = constrain((now.bpm - 60.0f) / 120.0f, 0.0f, 1.0f);
+        float energy = constrain(now.energy, 0.0f, 1.0f);
+        return (1.0f - 0.5f * fabsf(tempo - meta.preferredTempo)) * (1.0f - 0.5f * fabsf(energy - meta.intensity));
+    }
+
 public:
 void registerDefaultScenes() {
     for (const auto& entry : animationCatalog) {
-        scenes.push_back({
-            entry.type,
-            { LayerType::OVERLAY, LayerType::REACTIVE }, // placeholder
-            { entry.mood },
-            entry.name
-        });
+        SceneDefinition scene;
+        scene.setName(entry.name);
+        scene.baseAnimation = entry.type;
+        scene.moodMask = 1u << entry.mood;
+        scene.addLayer(LayerType::OVERLAY); // placeholder
+        scene.addLayer(LayerType::REACTIVE);
+        scenes.push_back(scene);
     }
+    registerCompiledScenes();
+    buildIndex();
 }
 
-    const SceneDefinition& pickSceneByMood(const SceneState& current, const MoodSnapshot& mood) const {
-        std::vector<const SceneDefinition*> moodMatches;
+    // Every compiled scene, next to the dynamic ones; call buildIndex() afterwards
+    void registerCompiledScenes() {
+        for (size_t i = 0; i < compiledSceneCatalog.size(); ++i) {
+            const CompiledSceneMeta& entry = compiledSceneCatalog[i];
+            SceneDefinition scene;
+            scene.setName(entry.name);
+            scene.baseAnimation = entry.animation;
+            scene.moodMask = entry.moodMask;
+            scene.compiledScene = (uint8_t)(i + 1);
+            scenes.push_back(scene);
+        }
+    }
 
-        for (const auto& scene : scenes) {
-            if (scene.supportsMood(mood.mood)) {
-                moodMatches.push_back(&scene);
+    // Rebuild the per-mood tables; call after changing the scene list
+    void buildIndex() {
+        for (int mood = 0; mood <= UNKNOWN; ++mood) {
+            std::vector<uint16_t> ids;
+            std::vector<float> weights;
+            for (size_t i = 0; i < scenes.size(); ++i) {
+                if (scenes[i].weight == 0) continue;
+                if (mood != UNKNOWN && !scenes[i].supportsMood((MoodType)mood)) continue;
+                ids.push_back((uint16_t)i);
+                weights.push_back(scenes[i].weight);
             }
+            byMood[mood].build(ids, weights);
         }
+        recentCount = 0;
+    }
 
-        if (!moodMatches.empty()) {
-            return *moodMatches[random(moodMatches.size())];
+    // Replace the registry with a scene table built by the scene compiler.
+    // Returns false, leaving the registry untouched, if the file is missing or invalid.
+    bool loadTable(const char* path) {
+        std::vector<uint8_t> data;
+        if (!SceneTable::readFile(path, data)) return false;
+        SceneTable::Status status = SceneTable::validate(data.data(), data.size());
+        if (status != SceneTable::Status::OK) {
+            Debug::logf(Debug::ERROR, "SceneRegistry: %s rejected (%s)", path, SceneTable::statusToString(status));
+            return false;
         }
+        std::vector<SceneDefinition> loaded;
+        SceneTable::decode(data.data(), loaded);
+        if (loaded.empty()) return false;
+        scenes.swap(loaded);
+        buildIndex();
+        Debug::logf(Debug::INFO, "SceneRegistry: %u scenes from %s", (unsigned)scenes.size(), path);
+        return true;
+    }
+
+    // Weighted draw among the mood's scenes (all scenes if none match). A draw is
+    // kept with probability fit(); recent scenes are skipped while the mood has
+    // others to offer. After SCENE_PICK_ATTEMPTS draws the best fit so far wins.
+    const SceneDefinition& pickSceneByMood(const SceneState& current, MoodType mood, const MoodSnapshot& now) {
+        const AliasTable* table = &byMood[mood <= UNKNOWN ? mood : UNKNOWN];
+        if (table->empty()) table = &byMood[UNKNOWN];
+        if (table->empty()) return scenes[random(scenes.size())];  // every weight is 0
 
-        // fallback
-        return scenes[random(scenes.size())];
+        const size_t window = min((size_t)SCENE_HISTORY_LENGTH, table->size() - 1);
+        int best = -1;
+        float bestFit = -1.0f;
+        for (int attempt = 0; attempt < SCENE_PICK_ATTEMPTS; ++attempt) {
+            uint16_t id = table->pick();
+            if (playedRecently(id, window)) continue;
+            float f = fit(scenes[id], now);
+            if (random(1000) < (long)(f * 1000)) {
+                best = id;
+                break;
+            }
+            if (f > bestFit) {
+                best = id;
+                bestFit = f;
+            }
+        }
+        if (best < 0) best = table->pick();
+        remember((uint16_t)best);
+        return scenes[best];
     }
 
     const SceneDefinition& get(size_t index) const {
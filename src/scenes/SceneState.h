@@ -2,7 +2,7 @@
 
 #include <Arduino.h>
 #include "SceneRegistry.h"
-#include "../scenes/SceneDirector.h"
+#include "../scenes/MoodHistory.h"
 
 
 struct SceneDefinition;
@@ -22,8 +22,9 @@ struct SceneState {
         activeScene = def;
         sceneStartMillis = millis();
         lastMood = moodNow;
-        sceneMinDurationMs = calculateMinDuration(moodNow);
-        sceneIdealDurationMs = calculateIdealDuration(moodNow);
+        // Durations set by the scene file win over the music-derived ones
+        sceneMinDurationMs = def && def->minDurationMs ? def->minDurationMs : calculateMinDuration(moodNow);
+        sceneIdealDurationMs = def && def->idealDurationMs ? def->idealDurationMs : calculateIdealDuration(moodNow);
         sceneChangeCount++;
     }
 
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#ifdef NATIVE_BUILD
+#include <cstdio>
+#else
+#include <LittleFS.h>
+#endif
+#include "SceneDefinition.h"
+#include "../animations/LayerCatalog.h"
+#include "CompiledSceneCatalog.h"
+
+// Binary scene table as stored on LittleFS (written by src/tools/SceneCompiler.cpp).
+//
+// Header:  u32 magic "GGSC" | u16 version | u16 sceneCount | u32 recordSize
+//          | u32 catalogHash | u32 checksum
+// Records: sceneCount x SceneDefinition, raw
+//
+// Records are the in-memory SceneDefinition bytes, so loading is one copy after
+// the header checks; nothing is parsed. Animations, layers and compiled scenes are
+// referenced by catalog index; catalogHash covers the catalog names in order, so a table built
+// against a different firmware is rejected instead of picking the wrong effects.
+class SceneTable {
+public:
+    static constexpr uint32_t magic = 0x43534747; // "GGSC" little-endian
+    static constexpr uint16_t version = 2;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t sceneCount;
+        uint32_t recordSize;
+        uint32_t catalogHash;
+        uint32_t checksum;
+    };
+
+    enum class Status {
+        OK,
+        TRUNCATED,
+        BAD_MAGIC,
+        BAD_VERSION,
+        LAYOUT_MISMATCH,
+        CATALOG_MISMATCH,
+        BAD_CHECKSUM,
+        BAD_RECORD
+    };
+
+    static const char* statusToString(Status status) {
+        switch (status) {
+            case Status::OK: return "ok";
+            case Status::TRUNCATED: return "file truncated";
+            case Status::BAD_MAGIC: return "not a scene table";
+            case Status::BAD_VERSION: return "unsupported version";
+            case Status::LAYOUT_MISMATCH: return "record layout differs from this firmware";
+            case Status::CATALOG_MISMATCH: return "built against a different animation/layer catalog";
+            case Status::BAD_CHECKSUM: return "checksum mismatch";
+            case Status::BAD_RECORD: return "record out of range";
+        }
+        return "unknown";
+    }
+
+    static uint32_t fnv1a(const void* data, size_t len, uint32_t hash = 2166136261u) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) hash = (hash ^ bytes[i]) * 16777619u;
+        return hash;
+    }
+
+    static uint32_t catalogHash() {
+        uint32_t hash = 2166136261u;
+        for (const auto& entry : animationCatalog) hash = fnv1a(entry.name, strlen(entry.name) + 1, hash);
+        for (const auto& entry : layerCatalog) hash = fnv1a(entry.name, strlen(entry.name) + 1, hash);
+        for (const auto& entry : compiledSceneCatalog) hash = fnv1a(entry.name, strlen(entry.name) + 1, hash);
+        const uint32_t counts[2] = { (uint32_t)LayerType::COUNT, (uint32_t)LayerBlend::COUNT };
+        return fnv1a(counts, sizeof(counts), hash);
+    }
+
+    // Range checks only; these are what the loader relies on to index the catalogs
+    static bool validRecord(const SceneDefinition& scene) {
+        if (memchr(scene.name, '\0', sizeof(scene.name)) == nullptr) return false;
+        if ((unsigned)scene.baseAnimation >= (unsigned)AnimationType::COUNT) return false;
+        if (scene.layerCount > SCENE_MAX_LAYERS) return false;
+        if (scene.compiledScene > compiledSceneCatalog.size()) return false;
+        if (scene.moodMask >> UNKNOWN) return false;
+        for (int i = 0; i < scene.layerCount; ++i) {
+            const SceneLayerSpec& layer = scene.layers[i];
+            if (layer.type >= LayerType::COUNT || layer.blend >= LayerBlend::COUNT) return false;
+            if (layer.catalogIndex < -1 || layer.catalogIndex >= (int)layerCatalog.size()) return false;
+        }
+        return true;
+    }
+
+    static Status validate(const uint8_t* data, size_t size) {
+        if (size < sizeof(Header)) return Status::TRUNCATED;
+        Header header;
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != magic) return Status::BAD_MAGIC;
+        if (header.version != version) return Status::BAD_VERSION;
+        if (header.recordSize != sizeof(SceneDefinition)) return Status::LAYOUT_MISMATCH;
+        if (header.catalogHash != catalogHash()) return Status::CATALOG_MISMATCH;
+        size_t recordBytes = (size_t)header.sceneCount * sizeof(SceneDefinition);
+        if (size < sizeof(Header) + recordBytes) return Status::TRUNCATED;
+        if (fnv1a(data + sizeof(Header), recordBytes) != header.checksum) return Status::BAD_CHECKSUM;
+
+        for (uint16_t i = 0; i < header.sceneCount; ++i) {
+            SceneDefinition scene;
+            memcpy(&scene, data + sizeof(Header) + i * sizeof(SceneDefinition), sizeof(scene));
+            if (!validRecord(scene)) return Status::BAD_RECORD;
+        }
+        return Status::OK;
+    }
+
+    // Copy the records of a validated table into `out`
+    static void decode(const uint8_t* data, std::vector<SceneDefinition>& out) {
+        Header header;
+        memcpy(&header, data, sizeof(header));
+        out.resize(header.sceneCount);
+        memcpy(out.data(), data + sizeof(Header), header.sceneCount * sizeof(SceneDefinition));
+    }
+
+    static std::vector<uint8_t> encode(const SceneDefinition* scenes, size_t count) {
+        Header header;
+        header.magic = magic;
+        header.version = version;
+        header.sceneCount = (uint16_t)count;
+        header.recordSize = sizeof(SceneDefinition);
+        header.catalogHash = catalogHash();
+        header.checksum = fnv1a(scenes, count * sizeof(SceneDefinition));
+
+        std::vector<uint8_t> data(sizeof(Header) + count * sizeof(SceneDefinition));
+        memcpy(data.data(), &header, sizeof(header));
+        memcpy(data.data() + sizeof(Header), scenes, count * sizeof(SceneDefinition));
+        return data;
+    }
+
+    // Whole file into `out`; LittleFS on device, the host filesystem natively
+    static bool readFile(const char* path, std::vector<uint8_t>& out) {
+#ifdef NATIVE_BUILD
+        FILE* file = fopen(path, "rb");
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        out.resize(size > 0 ? size : 0);
+        size_t got = fread(out.data(), 1, out.size(), file);
+        fclose(file);
+        return got == out.size();
+#else
+        if (!LittleFS.begin(false) || !LittleFS.exists(path)) return false;
+        File file = LittleFS.open(path, "r");
+        if (!file) return false;
+        out.resize(file.size());
+        size_t got = file.read(out.data(), out.size());
+        file.close();
+        return got == out.size();
+#endif
+    }
+};
+
+static_assert(sizeof(SceneTable::Header) == 20, "SceneTable::Header must stay packed");
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <FastLED.h>
+#include "../config/Config.h"
+
+// Ways to composite an outgoing and an incoming scene while a strip changes scene
+enum class TransitionStyle : uint8_t {
+    CROSSFADE,   // Every pixel blends from old to new
+    WIPE,        // A soft edge sweeps along the strip
+    DISSOLVE,    // Pixels switch over in a fixed pseudo-random order
+    COUNT
+};
+
+inline const char* transitionStyleToString(TransitionStyle style) {
+    switch (style) {
+        case TransitionStyle::CROSSFADE: return "CROSSFADE";
+        case TransitionStyle::WIPE: return "WIPE";
+        case TransitionStyle::DISSOLVE: return "DISSOLVE";
+        default: return "UNKNOWN";
+    }
+}
+
+// Cost of keeping the outgoing scene alive, summed over all strips
+struct TransitionStats {
+    uint32_t transitions = 0;
+    uint32_t frozenTransitions = 0;   // Outgoing scene stopped updating to stay in budget
+    uint32_t lastExtraUs = 0;
+    uint32_t peakExtraUs = 0;
+    float meanExtraUs = 0.0f;         // EMA over transition frames
+
+    void record(uint32_t extraUs) {
+        lastExtraUs = extraUs;
+        if (extraUs > peakExtraUs) peakExtraUs = extraUs;
+        meanExtraUs = meanExtraUs == 0.0f ? extraUs : meanExtraUs * 0.9f + extraUs * 0.1f;
+    }
+};
+
+// Write the blend of `from` and `to` at progress (0..255) into `out`
+inline void blendTransition(TransitionStyle style, const CRGB* from, const CRGB* to, CRGB* out,
+                            int count, uint8_t progress, uint8_t seed) {
+    switch (style) {
+        case TransitionStyle::WIPE: {
+            // Edge runs from before the first pixel to past the last so both ends fade fully
+            const int soft = max(1, count / 8);
+            const int edge = (int)((long)progress * (count + soft) / 255);
+            for (int i = 0; i < count; ++i) {
+                int w = constrain((edge - i) * 255 / soft, 0, 255);
+                out[i] = blend(from[i], to[i], w);
+            }
+            break;
+        }
+        case TransitionStyle::DISSOLVE: {
+            // Widen the progress range by the ramp so 0 and 255 are fully old and new
+            const int p = (int)progress * 319 / 255 - 32;
+            for (int i = 0; i < count; ++i) {
+                // Per-pixel threshold from a cheap integer hash; a short ramp avoids popping
+                uint8_t threshold = (uint8_t)((i * 167 + seed) * 73 >> 3);
+                int w = constrain((p - threshold) * 4 + 128, 0, 255);
+                out[i] = blend(from[i], to[i], w);
+            }
+            break;
+        }
+        case TransitionStyle::CROSSFADE:
+        default:
+            for (int i = 0; i < count; ++i) out[i] = blend(from[i], to[i], progress);
+            break;
+    }
+}
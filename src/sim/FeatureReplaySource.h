@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+#include "../audio/AudioFeatures.h"
+#include "../audio/FeatureStream.h"
+
+// Plays back a recorded AudioFeatures stream (see FeatureStream.h) frame by frame.
+// The whole recording is loaded up front; an hour of features is only a few MB.
+class FeatureReplaySource {
+private:
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+    FeatureStreamDecoder decoder;
+    uint32_t lastTimestamp = 0;
+
+public:
+    bool open(const char* path) {
+        FILE* file = fopen(path, "rb");
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        data.resize(size > 0 ? size : 0);
+        size_t got = fread(data.data(), 1, data.size(), file);
+        fclose(file);
+
+        if (got != data.size() || !FeatureStreamDecoder::validHeader(data.data(), data.size())) {
+            data.clear();
+            return false;
+        }
+        pos = FeatureStream::headerSize;
+        decoder = FeatureStreamDecoder();
+        return true;
+    }
+
+    // Returns false at the end of the recording (a truncated final frame is dropped).
+    bool next(AudioFeatures& features, uint32_t& timestampMs) {
+        if (pos >= data.size()) return false;
+        size_t consumed = decoder.decode(data.data() + pos, data.size() - pos, features, timestampMs);
+        if (consumed == 0) {
+            pos = data.size();
+            return false;
+        }
+        pos += consumed;
+        lastTimestamp = timestampMs;
+        return true;
+    }
+
+    uint32_t getLastTimestamp() const { return lastTimestamp; }
+    size_t getSizeBytes() const { return data.size(); }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <FastLED.h>
+
+// Dumps every registered strip's buffer once per frame.
+//
+// File layout (little-endian):
+//   "GGLF" | u16 version | u16 stripCount | u16 length[stripCount]
+//   per frame: u32 timestampMs | u8 brightness | RGB bytes of strip 0, strip 1, ...
+class LedFrameWriter {
+private:
+    static constexpr uint16_t version = 1;
+    FILE* file = nullptr;
+    uint32_t framesWritten = 0;
+
+    void writeU16(uint16_t v) {
+        uint8_t b[2] = { (uint8_t)(v & 0xFF), (uint8_t)(v >> 8) };
+        fwrite(b, 1, 2, file);
+    }
+
+    void writeU32(uint32_t v) {
+        uint8_t b[4] = { (uint8_t)(v & 0xFF), (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+        fwrite(b, 1, 4, file);
+    }
+
+public:
+    ~LedFrameWriter() { close(); }
+
+    bool open(const char* path, CFastLED& fastLed) {
+        close();
+        file = fopen(path, "wb");
+        if (!file) return false;
+
+        fwrite("GGLF", 1, 4, file);
+        writeU16(version);
+        writeU16((uint16_t)fastLed.count());
+        for (int i = 0; i < fastLed.count(); ++i) {
+            writeU16((uint16_t)fastLed[i].size());
+        }
+        return true;
+    }
+
+    void writeFrame(CFastLED& fastLed, uint32_t timestampMs) {
+        if (!file) return;
+        writeU32(timestampMs);
+        uint8_t brightness = fastLed.getBrightness();
+        fwrite(&brightness, 1, 1, file);
+        for (int i = 0; i < fastLed.count(); ++i) {
+            fwrite(fastLed[i].leds(), sizeof(CRGB), fastLed[i].size(), file);
+        }
+        ++framesWritten;
+    }
+
+    void close() {
+        if (file) fclose(file);
+        file = nullptr;
+    }
+
+    uint32_t getFramesWritten() const { return framesWritten; }
+};
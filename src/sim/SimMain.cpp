@@ -0,0 +1,69 @@
+// Native simulation entry point (PlatformIO env:native).
+//
+// Runs the full render pipeline off-device: a WAV file stands in for the I2S
+// microphone, AudioProcessor analyses it hop by hop, and LEDStripController drives
+// MoodHistory, SceneDirector, LayerManager and the animations exactly as on the
+// ESP32. The virtual clock advances by one audio hop per frame, so the output is
+// independent of host speed and the run finishes as fast as the CPU allows.
+//
+// Instead of a WAV file, a recorded AudioFeatures stream (--replay) can drive the
+// scene engine directly. With the same recording and --seed the LED output is
+// bit-identical between runs; the printed checksum makes that easy to compare.
+//
+// Usage: program (--wav <file.wav> | --replay <features.ggaf>) [--record features.ggaf]
+//                [--out frames.bin] [--frames N] [--fps N] [--seed N] [--scenes scenes.bin]
+//                [--layer-budget-us N] [--transition-freeze-us N] [--all-layers] [--fuse | --no-fuse] [--workers N] [--quiet]
+//
+// The layer quality governor acts on measured host time, so runs where it steps
+// in are not bit-reproducible; governor_degrades in the summary shows whether it did.
+// The transition freeze (TRANSITION_MAX_EXTRA_US) is measured the same way, so it
+// is off here unless --transition-freeze-us sets a budget; transitions_frozen counts it.
+// Strips render on one lane unless --workers asks for more: with several, layers
+// drawing from the shared random() get their numbers in whatever order the lanes
+// run, so only single-lane runs reproduce exactly.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Simulation.h"
+
+static bool parseOptions(int argc, char** argv, SimOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--wav") && hasValue) opts.wavPath = argv[++i];
+        else if (!strcmp(arg, "--replay") && hasValue) opts.replayPath = argv[++i];
+        else if (!strcmp(arg, "--record") && hasValue) opts.recordPath = argv[++i];
+        else if (!strcmp(arg, "--out") && hasValue) opts.outPath = argv[++i];
+        else if (!strcmp(arg, "--scenes") && hasValue) opts.scenesPath = argv[++i];
+        else if (!strcmp(arg, "--layer-budget-us") && hasValue) opts.layerBudgetUs = atol(argv[++i]);
+        else if (!strcmp(arg, "--transition-freeze-us") && hasValue) opts.transitionFreezeUs = atol(argv[++i]);
+        else if (!strcmp(arg, "--frames") && hasValue) opts.maxFrames = atol(argv[++i]);
+        else if (!strcmp(arg, "--fps") && hasValue) opts.fps = atof(argv[++i]);
+        else if (!strcmp(arg, "--seed") && hasValue) opts.seed = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--all-layers")) opts.allLayers = true;
+        else if (!strcmp(arg, "--workers") && hasValue) opts.workers = atoi(argv[++i]);
+        else if (!strcmp(arg, "--fuse")) opts.fuse = true;
+        else if (!strcmp(arg, "--no-fuse")) opts.fuse = false;
+        else if (!strcmp(arg, "--quiet")) opts.quiet = true;
+        else return false;
+    }
+    return (opts.wavPath != nullptr) != (opts.replayPath != nullptr);
+}
+
+// Unit test builds link Simulation.cpp and bring their own main()
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char** argv) {
+    SimOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        fprintf(stderr, "usage: %s (--wav <file.wav> | --replay <features.ggaf>) [--record features.ggaf]\n"
+                        "          [--out frames.bin] [--frames N] [--fps N] [--seed N] [--scenes scenes.bin]\n"
+                        "          [--layer-budget-us N] [--transition-freeze-us N] [--all-layers] [--fuse | --no-fuse] [--workers N] [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    SimResult result;
+    return runSimulation(opts, result);
+}
+#endif
@@ -0,0 +1,200 @@
+// The native simulation run itself, shared by the sim entry point (SimMain.cpp)
+// and the tests under test/.
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../config/Config.h"
+#include "../audio/AudioFeatures.h"
+#include "../audio/AudioProcessor.h"
+#include "../audio/AudioHistoryTracker.h"
+#include "../scenes/MoodHistory.h"
+#include "../core/LEDStripController.h"
+#include "../animations/LayerCatalog.h"
+#include "../audio/FeatureRecorder.h"
+#include "WavAudioSource.h"
+#include "FeatureReplaySource.h"
+#include "LedFrameWriter.h"
+#include "Simulation.h"
+
+// FNV-1a over every strip buffer, folded into a running hash per frame
+static uint32_t hashFrame(uint32_t hash) {
+    for (int i = 0; i < FastLED.count(); ++i) {
+        const uint8_t* bytes = FastLED[i].leds()->raw;
+        for (int j = 0; j < FastLED[i].size() * 3; ++j) {
+            hash = (hash ^ bytes[j]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+// Every catalogued layer, attached as persistent layers so each one runs every frame
+static void attachAllLayers(LayerManager& manager) {
+    for (const auto& entry : layerCatalog) {
+        VisualLayer* layer = entry.create();
+        layer->persistent = true;
+        manager.addLayer(layer, LayerType::OVERLAY);
+    }
+}
+
+int runSimulation(const SimOptions& opts, SimResult& result) {
+    WavAudioSource wav;
+    FeatureReplaySource replay;
+    if (opts.wavPath && !wav.open(opts.wavPath)) {
+        fprintf(stderr, "cannot read WAV file: %s\n", opts.wavPath);
+        return 1;
+    }
+    if (opts.replayPath && !replay.open(opts.replayPath)) {
+        fprintf(stderr, "cannot read feature recording: %s\n", opts.replayPath);
+        return 1;
+    }
+
+    native::setSerialMuted(opts.quiet);
+    randomSeed(opts.seed);
+    random16_set_seed((uint16_t)opts.seed);
+
+    static AudioFeatures audioFeatures;
+    static AudioHistoryTracker audioHistory;
+    static MoodHistory moodHistory;
+    static AudioProcessor audioProcessor;
+    static LEDStripController ledController(audioFeatures, moodHistory, audioHistory);
+
+    ledController.begin(opts.scenesPath);
+    if (opts.scenesPath && !ledController.hasSceneTable()) {
+        fprintf(stderr, "cannot load scene table: %s\n", opts.scenesPath);
+        return 1;
+    }
+    if (opts.layerBudgetUs >= 0) ledController.setLayerRenderBudget((uint32_t)opts.layerBudgetUs);
+    ledController.setFusedRendering(opts.fuse);
+    ledController.setTransitionFreezeBudget(opts.transitionFreezeUs > 0 ? (uint32_t)opts.transitionFreezeUs : 0);
+    if (!ledController.setRenderWorkers(opts.workers)) {
+        fprintf(stderr, "render lanes: %d of %d started\n", ledController.getRenderWorkers().getLanes(), opts.workers);
+    }
+    if (opts.allLayers) {
+        for (int i = 0; i < ledController.getStripCount(); ++i) {
+            attachAllLayers(ledController.getStrip(i).getLayerManager());
+        }
+    }
+
+    LedFrameWriter writer;
+    if (opts.outPath && !writer.open(opts.outPath, FastLED)) {
+        fprintf(stderr, "cannot write frames to: %s\n", opts.outPath);
+        return 1;
+    }
+
+    FeatureRecorder recorder;
+    if (opts.recordPath && !recorder.begin(opts.recordPath)) {
+        fprintf(stderr, "cannot record features to: %s\n", opts.recordPath);
+        return 1;
+    }
+
+    // By default one LED frame per analysis hop. With --fps the LED frames run on
+    // their own clock and an analysis result is delivered whenever one is due, as
+    // on device where capture no longer blocks the render loop.
+    const double hopMicros = NUM_SAMPLES * 1000000.0 / SAMPLE_RATE;
+    const double frameMicros = opts.fps > 0 ? 1000000.0 / opts.fps : 0.0;
+    double clockMicros = 0.0;
+    double nextAnalysisMicros = 0.0;
+    float samples[NUM_SAMPLES];
+    AudioFeatures pending;
+    uint32_t pendingTimestamp = 0;
+    bool havePending = false;
+    uint32_t checksum = 2166136261u;
+    long frames = 0;
+    double wattSum = 0.0;
+    double peakWatts = 0.0;
+    long limitedFrames = 0;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    while (opts.maxFrames < 0 || frames < opts.maxFrames) {
+        if (opts.replayPath) {
+            if (!havePending) {
+                havePending = replay.next(pending, pendingTimestamp);
+                if (!havePending) break;
+                if (frameMicros <= 0) clockMicros = pendingTimestamp * 1000.0;
+            }
+            native::setMicros((uint64_t)clockMicros);
+            if (clockMicros >= pendingTimestamp * 1000.0) {
+                audioFeatures = pending;
+                audioFeatures.timestamp = micros();
+                recorder.record(audioFeatures, millis());
+                havePending = false;
+            }
+        } else if (clockMicros >= nextAnalysisMicros) {
+            if (!wav.read(samples, NUM_SAMPLES)) break;
+            audioProcessor.loadSamples(samples, NUM_SAMPLES);
+            audioFeatures = audioProcessor.analyzeAudio();
+            recorder.record(audioFeatures, millis());
+            nextAnalysisMicros += hopMicros;
+        }
+
+        ledController.update();
+        writer.writeFrame(FastLED, millis());
+        checksum = hashFrame(checksum);
+        ++frames;
+
+        const PowerLimiter& power = ledController.getPowerLimiter();
+        wattSum += power.getWatts();
+        peakWatts = std::max(peakWatts, (double)power.getWatts());
+        if (power.getLimitedStripCount() > 0) ++limitedFrames;
+
+        if (frameMicros > 0) clockMicros += frameMicros;
+        else if (!opts.replayPath) clockMicros += hopMicros;
+        native::setMicros((uint64_t)clockMicros);
+    }
+    auto wallEnd = std::chrono::steady_clock::now();
+    recorder.end();
+
+    double wallSeconds = std::chrono::duration<double>(wallEnd - wallStart).count();
+    double audioSeconds = clockMicros / 1000000.0;
+    double fps = wallSeconds > 0 ? frames / wallSeconds : 0.0;
+
+    int totalLeds = 0;
+    for (int i = 0; i < FastLED.count(); ++i) totalLeds += FastLED[i].size();
+
+    LEDStripController::ArenaUsage arena = ledController.getArenaUsage();
+    double meanWatts = frames > 0 ? wattSum / frames : 0.0;
+    TransitionStats transitions = ledController.getTransitionStats();
+    const LayerPool::Stats& pool = ledController.getLayerPool().getStats();
+    GovernorStats governor = ledController.getGovernorStats();
+    const EventBus::Stats& events = ledController.getEventBus().getStats();
+    const RenderWorkers& workers = ledController.getRenderWorkers();
+    const RenderWorkers::Stats& lanes = workers.getStats();
+
+    for (const LayerCacheStats& cache : ledController.getCacheStats()) {
+        printf("layer_cache name=%s hits=%u misses=%u hit_rate=%.3f\n", cache.name,
+               (unsigned)cache.hits, (unsigned)cache.misses, cache.hitRate());
+    }
+    printf("events");
+    for (int i = 0; i < static_cast<int>(AudioEventType::COUNT); ++i) {
+        printf(" %s=%u", audioEventName(static_cast<AudioEventType>(i)), (unsigned)events.published[i]);
+    }
+    printf(" deliveries=%u dispatch_us=%u dispatch_us_peak=%u\n",
+           (unsigned)events.deliveries, (unsigned)events.dispatchUs, (unsigned)events.dispatchUsPeak);
+    printf("render lanes=%d batches=%u serial_batches=%u jobs=%u steals=%u", workers.getLanes(), (unsigned)lanes.batches,
+           (unsigned)lanes.serialBatches, (unsigned)lanes.jobs, (unsigned)lanes.steals);
+    for (int lane = 0; lane < workers.getLanes(); ++lane) printf(" lane%d_jobs=%u", lane, (unsigned)lanes.laneJobs[lane]);
+    printf(" efficiency=%.3f\n", lanes.efficiency);
+    printf("frames=%ld strips=%d leds=%d audio_s=%.2f wall_s=%.3f fps=%.1f realtime_x=%.1f checksum=%08x "
+           "arena=%zu scratch_peak=%zu/%zu watts_mean=%.2f watts_peak=%.2f limited_frames=%ld "
+           "transitions=%u transitions_frozen=%u transition_extra_us_peak=%u layers_spawned=%u layers_recycled=%u layer_budget_refused=%u "
+           "layer_us_peak=%.0f governor_degrades=%u governor_restores=%u layer_renders_skipped=%u layer_renders_fused=%u "
+           "layer_dormant_skips=%u\n",
+           frames, FastLED.count(), totalLeds, audioSeconds, wallSeconds, fps,
+           wallSeconds > 0 ? audioSeconds / wallSeconds : 0.0, checksum,
+           arena.capacity, arena.scratchPeak, arena.scratchCapacity, meanWatts, peakWatts, limitedFrames,
+           (unsigned)transitions.transitions, (unsigned)transitions.frozenTransitions, (unsigned)transitions.peakExtraUs,
+           (unsigned)pool.spawned, (unsigned)pool.recycled, (unsigned)ledController.getBudgetRejections(),
+           governor.peakStackUs, (unsigned)governor.degrades, (unsigned)governor.restores,
+           (unsigned)ledController.getSkippedRenders(), (unsigned)ledController.getFusedRenders(),
+           (unsigned)ledController.getDormantSkips());
+
+    result.frames = frames;
+    result.checksum = checksum;
+    result.audioSeconds = audioSeconds;
+    return 0;
+}
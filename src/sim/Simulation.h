@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include "../config/Config.h"
+
+// Command-line options of the native simulation (see SimMain.cpp)
+struct SimOptions {
+    const char* wavPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* recordPath = nullptr;
+    const char* outPath = nullptr;
+    const char* scenesPath = nullptr;
+    long layerBudgetUs = -1;
+    long transitionFreezeUs = 0;
+    int workers = 1;
+    long maxFrames = -1;
+    double fps = 0;
+    unsigned long seed = 1;
+    bool allLayers = false;
+    bool fuse = LAYER_FUSED_RENDERING;
+    bool quiet = false;
+};
+
+struct SimResult {
+    long frames = 0;
+    uint32_t checksum = 0;      // FNV-1a of every LED frame; equal for equal input and seed
+    double audioSeconds = 0.0;
+};
+
+// Runs the whole pipeline once and prints the summary line. Returns 0, or 1 if
+// an input or output file can't be opened. The controller and FastLED state are
+// process-wide, so call it once per process.
+int runSimulation(const SimOptions& opts, SimResult& result);
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include "../config/Config.h"
+
+// Streams a RIFF/WAVE file as mono float samples at SAMPLE_RATE.
+// Handles 8/16/24/32-bit PCM and 32-bit float; multi-channel input is downmixed
+// and other sample rates are linearly resampled, so any recording can drive
+// AudioProcessor the same way the I2S microphone does.
+class WavAudioSource {
+private:
+    static constexpr int readChunkFrames = 4096;
+
+    FILE* file = nullptr;
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint16_t bitsPerSample = 0;
+    uint32_t sourceRate = 0;
+    uint32_t dataBytes = 0;
+    uint32_t dataRemaining = 0;
+
+    std::vector<uint8_t> chunk;
+    size_t chunkPos = 0;
+    size_t chunkLen = 0;
+
+    double step = 1.0;
+    double phase = 0.0;
+    float s0 = 0.0f;
+    float s1 = 0.0f;
+    bool finished = false;
+
+    static uint16_t readU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    static uint32_t readU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+    int bytesPerFrame() const { return channels * (bitsPerSample / 8); }
+
+    float decodeSample(const uint8_t* p) const {
+        switch (bitsPerSample) {
+            case 8:  return (p[0] - 128) / 128.0f;
+            case 16: return (int16_t)readU16(p) / 32768.0f;
+            case 24: {
+                int32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+                if (v & 0x800000) v |= ~0xFFFFFF;
+                return v / 8388608.0f;
+            }
+            case 32: {
+                uint32_t raw = readU32(p);
+                if (format == 3) {
+                    float f;
+                    memcpy(&f, &raw, sizeof(f));
+                    return f;
+                }
+                return (int32_t)raw / 2147483648.0f;
+            }
+        }
+        return 0.0f;
+    }
+
+    bool readSourceFrame(float& out) {
+        const int frameBytes = bytesPerFrame();
+        if (chunkPos + frameBytes > chunkLen) {
+            size_t want = std::min<size_t>(chunk.size(), dataRemaining);
+            want -= want % frameBytes;
+            if (want == 0) return false;
+            chunkLen = fread(chunk.data(), 1, want, file);
+            chunkPos = 0;
+            dataRemaining -= chunkLen;
+            if (chunkLen < (size_t)frameBytes) return false;
+        }
+
+        const uint8_t* p = chunk.data() + chunkPos;
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            sum += decodeSample(p + c * (bitsPerSample / 8));
+        }
+        chunkPos += frameBytes;
+        out = sum / channels;
+        return true;
+    }
+
+public:
+    ~WavAudioSource() { close(); }
+
+    bool open(const char* path) {
+        close();
+        file = fopen(path, "rb");
+        if (!file) return false;
+        format = channels = bitsPerSample = 0;
+        sourceRate = dataBytes = dataRemaining = 0;
+
+        uint8_t header[12];
+        if (fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+            close();
+            return false;
+        }
+
+        bool haveFormat = false;
+        uint8_t chunkHeader[8];
+        while (fread(chunkHeader, 1, 8, file) == 8) {
+            uint32_t size = readU32(chunkHeader + 4);
+            if (memcmp(chunkHeader, "fmt ", 4) == 0) {
+                std::vector<uint8_t> fmt(size);
+                if (size < 16 || fread(fmt.data(), 1, size, file) != size) break;
+                format = readU16(&fmt[0]);
+                channels = readU16(&fmt[2]);
+                sourceRate = readU32(&fmt[4]);
+                bitsPerSample = readU16(&fmt[14]);
+                if (format == 0xFFFE && size >= 26) format = readU16(&fmt[24]); // WAVE_FORMAT_EXTENSIBLE
+                if (size & 1) fseek(file, 1, SEEK_CUR);
+                haveFormat = true;
+            } else if (memcmp(chunkHeader, "data", 4) == 0) {
+                dataBytes = dataRemaining = size;
+                break;
+            } else {
+                fseek(file, size + (size & 1), SEEK_CUR);
+            }
+        }
+
+        bool supported = haveFormat && dataBytes > 0 && channels > 0 && sourceRate > 0
+            && (format == 1 || (format == 3 && bitsPerSample == 32))
+            && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+        if (!supported) {
+            close();
+            return false;
+        }
+
+        chunk.resize(readChunkFrames * bytesPerFrame());
+        chunkPos = chunkLen = 0;
+        step = (double)sourceRate / SAMPLE_RATE;
+        phase = 0.0;
+        finished = !readSourceFrame(s0) || !readSourceFrame(s1);
+        return true;
+    }
+
+    void close() {
+        if (file) fclose(file);
+        file = nullptr;
+        finished = true;
+    }
+
+    // Fill `out` with `count` samples; a short final block is zero-padded.
+    // Returns false once the file is exhausted.
+    bool read(float* out, int count) {
+        if (finished) return false;
+        for (int i = 0; i < count; ++i) {
+            while (phase >= 1.0) {
+                s0 = s1;
+                if (!readSourceFrame(s1)) {
+                    finished = true;
+                    for (; i < count; ++i) out[i] = 0.0f;
+                    return true;
+                }
+                phase -= 1.0;
+            }
+            out[i] = s0 + (s1 - s0) * (float)phase;
+            phase += step;
+        }
+        return true;
+    }
+
+    uint32_t getSourceRate() const { return sourceRate; }
+    uint16_t getChannels() const { return channels; }
+    float getDurationSeconds() const {
+        return bytesPerFrame() > 0 ? (float)dataBytes / bytesPerFrame() / sourceRate : 0.0f;
+    }
+};
@@ -0,0 +1,494 @@
+// Scene compiler (PlatformIO env:scene-compiler).
+//
+// Validates a JSON scene description and writes the binary scene table the
+// firmware loads from LittleFS (format in src/scenes/SceneTable.h). It links the
+// same animation, layer and compiled scene catalogs as the firmware, so every name in the JSON is
+// checked against what the device can actually instantiate.
+//
+// Usage: program <scenes.json> <scenes.bin>   compile
+//        program --check <scenes.bin>         validate a compiled table and list it
+//        program --list                       names accepted in the JSON
+//
+// JSON layout (see scenes/scenes.json):
+//   { "scenes": [ { "name": "...", "animation": "<animationCatalog name>" | "compiled": "<compiledSceneCatalog name>",
+//                   "moods": ["Calm" | "Energetic" | "Intense" | "Floaty", ...], "weight": 0..255,
+//                   "minDurationMs": N, "idealDurationMs": N,
+//                   "layers": [ { "layer": "<layerCatalog name>", "type": "OVERLAY",
+//                                 "opacity": 0..255, "blend": "add",
+//                                 "speed": 1..255, "lifetimeMs": N }, ... ] }, ... ] }
+// A layer without "layer" picks a random pooled layer of its "type" at runtime.
+// A compiled scene brings its own animation and layers; "layers" adds more on top.
+
+#include <Arduino.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../scenes/SceneDefinition.h"
+#include "../scenes/SceneTable.h"
+
+namespace {
+
+struct JsonValue {
+    enum Kind { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } kind = NUL;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(const char* key) const {
+        for (const auto& m : members) {
+            if (m.first == key) return &m.second;
+        }
+        return nullptr;
+    }
+};
+
+// Just enough JSON for hand-written scene files: no \u escapes beyond ASCII
+class JsonParser {
+public:
+    JsonParser(const std::string& source) : src(source) {}
+
+    bool parse(JsonValue& out) {
+        skipSpace();
+        if (!value(out)) return false;
+        skipSpace();
+        if (pos != src.size()) return fail("trailing characters");
+        return true;
+    }
+
+    const std::string& getError() const { return error; }
+
+private:
+    const std::string& src;
+    size_t pos = 0;
+    std::string error;
+
+    bool fail(const char* what) {
+        int line = 1;
+        for (size_t i = 0; i < pos && i < src.size(); ++i) line += src[i] == '\n';
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "line %d: %s", line, what);
+        error = buffer;
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < src.size() && isspace((unsigned char)src[pos])) ++pos;
+    }
+
+    bool literal(const char* word) {
+        size_t len = strlen(word);
+        if (src.compare(pos, len, word) != 0) return false;
+        pos += len;
+        return true;
+    }
+
+    bool value(JsonValue& out) {
+        if (pos >= src.size()) return fail("unexpected end of file");
+        char c = src[pos];
+        if (c == '{') return object(out);
+        if (c == '[') return array(out);
+        if (c == '"') {
+            out.kind = JsonValue::STRING;
+            return string(out.text);
+        }
+        if (literal("true")) { out.kind = JsonValue::BOOL; out.boolean = true; return true; }
+        if (literal("false")) { out.kind = JsonValue::BOOL; out.boolean = false; return true; }
+        if (literal("null")) { out.kind = JsonValue::NUL; return true; }
+        char* end = nullptr;
+        out.number = strtod(src.c_str() + pos, &end);
+        if (end == src.c_str() + pos) return fail("expected a value");
+        out.kind = JsonValue::NUMBER;
+        pos = end - src.c_str();
+        return true;
+    }
+
+    bool string(std::string& out) {
+        ++pos;
+        while (pos < src.size() && src[pos] != '"') {
+            char c = src[pos++];
+            if (c == '\\') {
+                if (pos >= src.size()) break;
+                char e = src[pos++];
+                c = e == 'n' ? '\n' : e == 't' ? '\t' : e;
+            }
+            out += c;
+        }
+        if (pos >= src.size()) return fail("unterminated string");
+        ++pos;
+        return true;
+    }
+
+    bool array(JsonValue& out) {
+        out.kind = JsonValue::ARRAY;
+        ++pos;
+        skipSpace();
+        if (pos < src.size() && src[pos] == ']') { ++pos; return true; }
+        while (true) {
+            JsonValue item;
+            skipSpace();
+            if (!value(item)) return false;
+            out.items.push_back(std::move(item));
+            skipSpace();
+            if (pos < src.size() && src[pos] == ',') { ++pos; continue; }
+            if (pos < src.size() && src[pos] == ']') { ++pos; return true; }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool object(JsonValue& out) {
+        out.kind = JsonValue::OBJECT;
+        ++pos;
+        skipSpace();
+        if (pos < src.size() && src[pos] == '}') { ++pos; return true; }
+        while (true) {
+            skipSpace();
+            if (pos >= src.size() || src[pos] != '"') return fail("expected a key");
+            std::string key;
+            if (!string(key)) return false;
+            skipSpace();
+            if (pos >= src.size() || src[pos] != ':') return fail("expected ':'");
+            ++pos;
+            skipSpace();
+            JsonValue item;
+            if (!value(item)) return false;
+            out.members.emplace_back(std::move(key), std::move(item));
+            skipSpace();
+            if (pos < src.size() && src[pos] == ',') { ++pos; continue; }
+            if (pos < src.size() && src[pos] == '}') { ++pos; return true; }
+            return fail("expected ',' or '}'");
+        }
+    }
+};
+
+// Collects every problem in the file instead of stopping at the first
+class SceneCompiler {
+public:
+    std::vector<SceneDefinition> scenes;
+    int errors = 0;
+
+    void compile(const JsonValue& root) {
+        const JsonValue* list = root.kind == JsonValue::OBJECT ? root.find("scenes") : nullptr;
+        if (!list || list->kind != JsonValue::ARRAY) {
+            report("", "expected an object with a \"scenes\" array");
+            return;
+        }
+        if (list->items.empty()) report("scenes", "no scenes defined");
+        if (list->items.size() > 0xFFFF) report("scenes", "too many scenes");
+
+        std::map<std::string, int> seen;
+        for (size_t i = 0; i < list->items.size(); ++i) {
+            std::string where = "scenes[" + std::to_string(i) + "]";
+            SceneDefinition scene;
+            if (compileScene(list->items[i], where, scene)) {
+                if (seen.count(scene.name)) report(where + ".name", "duplicate scene name");
+                seen[scene.name] = (int)i;
+                scenes.push_back(scene);
+            }
+        }
+    }
+
+private:
+    void report(const std::string& where, const std::string& what) {
+        fprintf(stderr, "error: %s%s%s\n", where.c_str(), where.empty() ? "" : ": ", what.c_str());
+        ++errors;
+    }
+
+    bool integer(const JsonValue* v, const std::string& where, long minValue, long maxValue, long& out) {
+        if (!v) return true;
+        if (v->kind != JsonValue::NUMBER || v->number != (long)v->number) {
+            report(where, "expected an integer");
+            return false;
+        }
+        if (v->number < minValue || v->number > maxValue) {
+            report(where, "must be between " + std::to_string(minValue) + " and " + std::to_string(maxValue));
+            return false;
+        }
+        out = (long)v->number;
+        return true;
+    }
+
+    const std::string* text(const JsonValue* v, const std::string& where) {
+        if (!v) return nullptr;
+        if (v->kind != JsonValue::STRING) {
+            report(where, "expected a string");
+            return nullptr;
+        }
+        return &v->text;
+    }
+
+    static bool sameName(const std::string& a, const char* b) {
+        return strcasecmp(a.c_str(), b) == 0;
+    }
+
+    bool compileScene(const JsonValue& v, const std::string& where, SceneDefinition& scene) {
+        if (v.kind != JsonValue::OBJECT) {
+            report(where, "expected an object");
+            return false;
+        }
+        int before = errors;
+        static const char* known[] = { "name", "animation", "compiled", "moods", "weight", "minDurationMs", "idealDurationMs", "layers" };
+        checkKeys(v, where, known, sizeof(known) / sizeof(known[0]));
+
+        const std::string* name = text(v.find("name"), where + ".name");
+        if (!name) report(where + ".name", "required");
+        else if (name->empty() || name->size() >= SCENE_NAME_LENGTH) {
+            report(where + ".name", "must be 1.." + std::to_string(SCENE_NAME_LENGTH - 1) + " characters");
+        } else {
+            scene.setName(name->c_str());
+        }
+
+        const std::string* compiled = text(v.find("compiled"), where + ".compiled");
+        if (compiled) {
+            for (size_t i = 0; i < compiledSceneCatalog.size(); ++i) {
+                if (!sameName(*compiled, compiledSceneCatalog[i].name)) continue;
+                scene.compiledScene = (uint8_t)(i + 1);
+                scene.baseAnimation = compiledSceneCatalog[i].animation;
+            }
+            if (!scene.compiledScene) report(where + ".compiled", "unknown compiled scene \"" + *compiled + "\" (see --list)");
+        }
+
+        const std::string* animation = text(v.find("animation"), where + ".animation");
+        if (compiled && animation) {
+            report(where + ".animation", "a compiled scene has its own animation");
+        } else if (!animation) {
+            if (!compiled) report(where + ".animation", "\"animation\" or \"compiled\" is required");
+        } else {
+            bool found = false;
+            for (const auto& entry : animationCatalog) {
+                if (sameName(*animation, entry.name)) {
+                    scene.baseAnimation = entry.type;
+                    found = true;
+                }
+            }
+            if (!found) report(where + ".animation", "unknown animation \"" + *animation + "\" (see --list)");
+        }
+
+        const JsonValue* moods = v.find("moods");
+        if (moods && moods->kind != JsonValue::ARRAY) report(where + ".moods", "expected an array");
+        else if (moods) {
+            for (size_t i = 0; i < moods->items.size(); ++i) {
+                std::string at = where + ".moods[" + std::to_string(i) + "]";
+                const std::string* mood = text(&moods->items[i], at);
+                if (!mood) continue;
+                bool found = false;
+                for (int m = CALM; m < UNKNOWN; ++m) {
+                    if (sameName(*mood, moodToString((MoodType)m))) {
+                        scene.moodMask |= 1u << m;
+                        found = true;
+                    }
+                }
+                if (!found) report(at, "unknown mood \"" + *mood + "\"");
+            }
+        }
+        if (scene.moodMask == 0 && scene.compiledScene) {
+            scene.moodMask = compiledSceneCatalog[scene.compiledScene - 1].moodMask;
+        } else if (scene.moodMask == 0) {
+            // Without a mood the scene is only reachable through the random fallback
+            scene.moodMask = 1u << animationMood(scene.baseAnimation);
+        }
+
+        long weight = scene.weight;
+        integer(v.find("weight"), where + ".weight", 0, 255, weight);
+        scene.weight = (uint8_t)weight;
+
+        long minMs = 0, idealMs = 0;
+        integer(v.find("minDurationMs"), where + ".minDurationMs", 0, 3600000, minMs);
+        integer(v.find("idealDurationMs"), where + ".idealDurationMs", 0, 3600000, idealMs);
+        if (idealMs && minMs > idealMs) report(where + ".idealDurationMs", "shorter than minDurationMs");
+        scene.minDurationMs = minMs;
+        scene.idealDurationMs = idealMs;
+
+        const JsonValue* layers = v.find("layers");
+        if (layers && layers->kind != JsonValue::ARRAY) report(where + ".layers", "expected an array");
+        else if (layers) {
+            if (layers->items.size() > SCENE_MAX_LAYERS) {
+                report(where + ".layers", "at most " + std::to_string(SCENE_MAX_LAYERS) + " layers (SCENE_MAX_LAYERS)");
+            }
+            for (size_t i = 0; i < layers->items.size() && i < SCENE_MAX_LAYERS; ++i) {
+                SceneLayerSpec spec;
+                if (compileLayer(layers->items[i], where + ".layers[" + std::to_string(i) + "]", spec)) {
+                    scene.addLayer(spec);
+                }
+            }
+        }
+        return errors == before;
+    }
+
+    bool compileLayer(const JsonValue& v, const std::string& where, SceneLayerSpec& spec) {
+        if (v.kind != JsonValue::OBJECT) {
+            report(where, "expected an object");
+            return false;
+        }
+        int before = errors;
+        static const char* known[] = { "layer", "type", "opacity", "blend", "speed", "lifetimeMs" };
+        checkKeys(v, where, known, sizeof(known) / sizeof(known[0]));
+
+        const std::string* layer = text(v.find("layer"), where + ".layer");
+        if (layer) {
+            for (size_t i = 0; i < layerCatalog.size(); ++i) {
+                if (sameName(*layer, layerCatalog[i].name)) spec.catalogIndex = (int16_t)i;
+            }
+            if (spec.catalogIndex < 0) report(where + ".layer", "unknown layer \"" + *layer + "\" (see --list)");
+        }
+
+        const std::string* type = text(v.find("type"), where + ".type");
+        if (type) {
+            bool found = false;
+            for (int t = 0; t < (int)LayerType::COUNT; ++t) {
+                if (sameName(*type, layerTypeToString((LayerType)t))) {
+                    spec.type = (LayerType)t;
+                    found = true;
+                }
+            }
+            if (!found) report(where + ".type", "unknown layer type \"" + *type + "\"");
+        } else if (!layer) {
+            report(where, "needs a \"layer\" name or a \"type\" to pick from");
+        }
+
+        const std::string* blend = text(v.find("blend"), where + ".blend");
+        if (blend) {
+            bool found = false;
+            for (int b = 0; b < (int)LayerBlend::COUNT; ++b) {
+                if (sameName(*blend, layerBlendToString((LayerBlend)b))) {
+                    spec.blend = (LayerBlend)b;
+                    found = true;
+                }
+            }
+            if (!found) report(where + ".blend", "unknown blend mode \"" + *blend + "\"");
+        }
+
+        long opacity = spec.opacity, speed = spec.speed, lifetime = 0;
+        integer(v.find("opacity"), where + ".opacity", 0, 255, opacity);
+        integer(v.find("speed"), where + ".speed", 1, 255, speed);
+        integer(v.find("lifetimeMs"), where + ".lifetimeMs", 0, 3600000, lifetime);
+        spec.opacity = (uint8_t)opacity;
+        spec.speed = (uint8_t)speed;
+        spec.lifetimeMs = (uint32_t)lifetime;
+        return errors == before;
+    }
+
+    // Misspelt keys would otherwise be silently ignored
+    void checkKeys(const JsonValue& v, const std::string& where, const char* const* known, size_t count) {
+        for (const auto& m : v.members) {
+            bool ok = false;
+            for (size_t i = 0; i < count; ++i) ok |= m.first == known[i];
+            if (!ok) report(where, "unknown key \"" + m.first + "\"");
+        }
+    }
+};
+
+bool readText(const char* path, std::string& out) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char buffer[4096];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) out.append(buffer, got);
+    fclose(file);
+    return true;
+}
+
+void printScene(const SceneDefinition& scene) {
+    printf("%-23s %-20s moods:", scene.name,
+           scene.compiledScene ? compiledSceneCatalog[scene.compiledScene - 1].name : animationTypeToString(scene.baseAnimation));
+    for (int m = CALM; m < UNKNOWN; ++m) {
+        if (scene.supportsMood((MoodType)m)) printf(" %s", moodToString((MoodType)m));
+    }
+    if (scene.weight != 100) printf("  weight: %u", scene.weight);
+    if (scene.minDurationMs || scene.idealDurationMs) {
+        printf("  duration: %u..%u ms", (unsigned)scene.minDurationMs, (unsigned)scene.idealDurationMs);
+    }
+    printf("\n");
+    for (int i = 0; i < scene.layerCount; ++i) {
+        const SceneLayerSpec& layer = scene.layers[i];
+        printf("    %-22s %-10s opacity %3u  %-7s speed %3u%%",
+               layer.catalogIndex >= 0 ? layerCatalog[layer.catalogIndex].name : "(random)",
+               layerTypeToString(layer.type), layer.opacity, layerBlendToString(layer.blend), layer.speed);
+        if (layer.lifetimeMs) printf("  lifetime %u ms", (unsigned)layer.lifetimeMs);
+        printf("\n");
+    }
+}
+
+int listNames() {
+    printf("animations:");
+    for (const auto& entry : animationCatalog) printf(" \"%s\"", entry.name);
+    printf("\nlayers:");
+    for (const auto& entry : layerCatalog) printf(" \"%s\"", entry.name);
+    printf("\ncompiled:");
+    for (const auto& entry : compiledSceneCatalog) printf(" \"%s\"", entry.name);
+    printf("\ntypes:");
+    for (int t = 0; t < (int)LayerType::COUNT; ++t) printf(" %s", layerTypeToString((LayerType)t));
+    printf("\nblends:");
+    for (int b = 0; b < (int)LayerBlend::COUNT; ++b) printf(" %s", layerBlendToString((LayerBlend)b));
+    printf("\nmoods:");
+    for (int m = CALM; m < UNKNOWN; ++m) printf(" %s", moodToString((MoodType)m));
+    printf("\n");
+    return 0;
+}
+
+int checkTable(const char* path) {
+    std::vector<uint8_t> data;
+    if (!SceneTable::readFile(path, data)) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    SceneTable::Status status = SceneTable::validate(data.data(), data.size());
+    if (status != SceneTable::Status::OK) {
+        fprintf(stderr, "%s: %s\n", path, SceneTable::statusToString(status));
+        return 1;
+    }
+    std::vector<SceneDefinition> scenes;
+    SceneTable::decode(data.data(), scenes);
+    for (const auto& scene : scenes) printScene(scene);
+    printf("%s: %zu scenes, %zu bytes, ok\n", path, scenes.size(), data.size());
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 2 && !strcmp(argv[1], "--list")) return listNames();
+    if (argc == 3 && !strcmp(argv[1], "--check")) return checkTable(argv[2]);
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <scenes.json> <scenes.bin>\n"
+                        "       %s --check <scenes.bin>\n"
+                        "       %s --list\n", argv[0], argv[0], argv[0]);
+        return 2;
+    }
+
+    std::string source;
+    if (!readText(argv[1], source)) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    JsonValue root;
+    JsonParser parser(source);
+    if (!parser.parse(root)) {
+        fprintf(stderr, "error: %s: %s\n", argv[1], parser.getError().c_str());
+        return 1;
+    }
+
+    SceneCompiler compiler;
+    compiler.compile(root);
+    if (compiler.errors > 0) {
+        fprintf(stderr, "%s: %d error(s), nothing written\n", argv[1], compiler.errors);
+        return 1;
+    }
+
+    std::vector<uint8_t> table = SceneTable::encode(compiler.scenes.data(), compiler.scenes.size());
+    FILE* out = fopen(argv[2], "wb");
+    if (!out || fwrite(table.data(), 1, table.size(), out) != table.size()) {
+        fprintf(stderr, "cannot write %s\n", argv[2]);
+        if (out) fclose(out);
+        return 1;
+    }
+    fclose(out);
+    printf("%s: %zu scenes, %zu bytes\n", argv[2], compiler.scenes.size(), table.size());
+    return 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+// Weighted random choice in O(1) (Walker/Vose alias method). Built once from a
+// list of item ids and weights; each pick is one random column plus one coin flip
+// and touches no heap.
+class AliasTable {
+public:
+    void build(const std::vector<uint16_t>& ids, const std::vector<float>& weights) {
+        const size_t n = ids.size();
+        items = ids;
+        threshold.assign(n, 0);
+        alias.assign(n, 0);
+        if (n == 0) return;
+
+        float total = 0;
+        for (float w : weights) total += w > 0 ? w : 0;
+
+        // Scale so the average column holds exactly 1.0, then pair short and long columns
+        std::vector<float> scaled(n);
+        std::vector<uint16_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            float w = weights[i] > 0 ? weights[i] : 0;
+            scaled[i] = total > 0 ? w * n / total : 1.0f;
+            (scaled[i] < 1.0f ? small : large).push_back((uint16_t)i);
+        }
+        while (!small.empty() && !large.empty()) {
+            uint16_t s = small.back(); small.pop_back();
+            uint16_t l = large.back();
+            threshold[s] = toThreshold(scaled[s]);
+            alias[s] = l;
+            scaled[l] -= 1.0f - scaled[s];
+            if (scaled[l] < 1.0f) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Leftovers are 1.0 up to rounding
+        for (uint16_t i : large) { threshold[i] = fullThreshold; alias[i] = i; }
+        for (uint16_t i : small) { threshold[i] = fullThreshold; alias[i] = i; }
+    }
+
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    const std::vector<uint16_t>& ids() const { return items; }
+
+    // One weighted draw; returns an id passed to build()
+    uint16_t pick() const {
+        size_t column = random(items.size());
+        uint16_t coin = (uint16_t)random(fullThreshold);
+        return items[coin < threshold[column] ? column : alias[column]];
+    }
+
+private:
+    static constexpr uint32_t fullThreshold = 65535;
+
+    static uint16_t toThreshold(float p) {
+        return p >= 1.0f ? fullThreshold : (uint16_t)(p * fullThreshold);
+    }
+
+    std::vector<uint16_t> items;
+    std::vector<uint16_t> threshold;
+    std::vector<uint16_t> alias;
+};
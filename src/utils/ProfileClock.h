@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Arduino.h>
+#ifdef NATIVE_BUILD
+#include <chrono>
+#endif
+
+// Microseconds for measuring how long code takes. On device this is micros(); the
+// native build runs micros() from a virtual clock that stands still within a frame,
+// so it reads the host's steady clock instead.
+inline uint32_t profileMicros() {
+#ifdef NATIVE_BUILD
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return micros();
+#endif
+}
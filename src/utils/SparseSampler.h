@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include <stdint.h>
+
+// Small PCG32 generator (O'Neill, PCG-XSH-RR). Each instance is its own stream,
+// so a layer's sparkles don't shift when another layer draws more numbers.
+class Pcg32 {
+public:
+    Pcg32() { seed(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL); }
+
+    void seed(uint64_t initState, uint64_t stream) {
+        state = 0;
+        inc = (stream << 1) | 1u;
+        next();
+        state += initState;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    uint8_t next8() { return (uint8_t)(next() >> 24); }
+
+    // [lo, hi)
+    uint8_t next8(uint8_t lo, uint8_t hi) {
+        return hi > lo ? lo + (uint8_t)(((uint32_t)next8() * (hi - lo)) >> 8) : lo;
+    }
+
+    // (0, 1]: never zero, so it is safe to take the log of
+    float nextUnit() { return ((next() >> 8) + 1) * (1.0f / 16777216.0f); }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
+
+// Visits each index of a range independently with probability p, in time
+// proportional to the hits rather than the range. Instead of one coin flip per
+// index it draws the gap to the next hit from the geometric distribution,
+// floor(log(u) / log(1 - p)), so a 3000-LED strip at 1% costs about 30 draws.
+class SparseSampler {
+public:
+    // Stream chosen by label so two layers seeded alike still differ
+    void seed(uint32_t seedValue, const char* label) {
+        uint64_t stream = 1469598103934665603ULL;
+        for (const char* c = label; c && *c; ++c) stream = (stream ^ (uint8_t)*c) * 1099511628211ULL;
+        rng.seed(seedValue, stream);
+    }
+
+    // Seed from Arduino's random(n), which randomSeed() and so the sim's --seed
+    // control. Zero-argument random() is libc's and ignores both.
+    void seed(const char* label) {
+        seed((uint32_t)random(0x7FFFFFFF), label);
+    }
+
+    // Calls hit(index) for each selected index in [0, count); returns the hits
+    template<typename Fn>
+    int forEach(int count, float probability, Fn&& hit) {
+        if (count <= 0 || probability <= 0.0f) return 0;
+        int hits = 0;
+        if (probability >= 1.0f) {
+            for (int i = 0; i < count; ++i) hit(i);
+            return count;
+        }
+        // log1pf keeps tiny probabilities: 1 - p rounds to 1 below about 6e-8,
+        // and the gaps would come out as inf/NaN. A zero log means the first hit
+        // lies far past any strip.
+        const float logMiss = log1pf(-probability);
+        if (!(logMiss < 0.0f) || isinf(logMiss)) return 0;
+        const float invLogMiss = 1.0f / logMiss;
+        for (int i = gap(invLogMiss, count); i < count; i += 1 + gap(invLogMiss, count)) {
+            hit(i);
+            hits++;
+        }
+        return hits;
+    }
+
+    Pcg32& generator() { return rng; }
+
+private:
+    Pcg32 rng;
+
+    // Clamped to [0, limit]; also catches NaN, which fails every comparison
+    int gap(float invLogMiss, int limit) {
+        float skip = logf(rng.nextUnit()) * invLogMiss;
+        if (!(skip < (float)limit)) return limit;
+        return skip > 0.0f ? (int)skip : 0;
+    }
+};
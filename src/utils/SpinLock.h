@@ -0,0 +1,49 @@
+#pragma once
+
+#ifdef NATIVE_BUILD
+#include <atomic>
+#include <thread>
+#else
+#include <freertos/FreeRTOS.h>
+#endif
+
+// Short critical section shared by the render lanes (src/core/RenderWorkers.h).
+// On the ESP32 it is a FreeRTOS spinlock, which also holds off interrupts and
+// task switches on the owning core, so keep what it guards to a few stores: no
+// heap, no logging. The native build spins on an atomic flag.
+class SpinLock {
+public:
+    void lock() {
+#ifdef NATIVE_BUILD
+        while (flag.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+#else
+        portENTER_CRITICAL(&mux);
+#endif
+    }
+
+    void unlock() {
+#ifdef NATIVE_BUILD
+        flag.clear(std::memory_order_release);
+#else
+        portEXIT_CRITICAL(&mux);
+#endif
+    }
+
+private:
+#ifdef NATIVE_BUILD
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+#else
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+class SpinLockGuard {
+public:
+    explicit SpinLockGuard(SpinLock& l) : lock(l) { lock.lock(); }
+    ~SpinLockGuard() { lock.unlock(); }
+    SpinLockGuard(const SpinLockGuard&) = delete;
+    SpinLockGuard& operator=(const SpinLockGuard&) = delete;
+
+private:
+    SpinLock& lock;
+};
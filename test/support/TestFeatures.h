@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "../../src/audio/AudioFeatures.h"
+#include "../../src/audio/FeatureStream.h"
+
+// Synthetic AudioFeatures frames for the stream and replay tests: a 120 BPM
+// pulse with a wandering dominant band, in whole milliseconds like a recording.
+struct TestFeatures {
+    static const uint32_t frameMs = 23;     // About one analysis hop
+
+    static AudioFeatures frame(int i) {
+        AudioFeatures f;
+        float t = i * frameMs / 1000.0f;
+        float phase = fmodf(t * 2.0f, 1.0f);
+        float pulse = phase < 0.15f ? 1.0f : 0.2f;
+        f.volume = 0.3f * pulse;
+        f.loudness = 60.0f * pulse;
+        f.peak = 0.5f * pulse;
+        f.average = 0.1f * pulse;
+        f.agcLevel = 1.5f;
+        f.bass = 0.8f * pulse;
+        f.mid = 0.3f + 0.1f * sinf(t);
+        f.treble = 0.1f;
+        f.spectrumCentroid = 1200.0f + 400.0f * sinf(t * 0.7f);
+        f.dominantBand = 4 + (i / 7) % 40;
+        f.dynamics = f.peak - f.average;
+        f.energy = 900.0f * pulse;
+        f.beatDetected = phase < 0.05f;
+        f.bpm = 120.0f;
+        f.bassHits = i / 22;
+        f.noiseFloor = 0.01f;
+        f.signalPresence = true;
+        f.frequency = 110.0f;
+        for (int bin = 1; bin < NUM_SAMPLES / 2; ++bin) f.spectrum[bin] = 4000.0f * pulse / bin;
+        return f;
+    }
+
+    static uint32_t timestamp(int i) { return 1000 + i * frameMs; }
+
+    // The encoded stream; frameStart[i] is where frame i begins
+    static std::vector<uint8_t> encode(int frames, std::vector<size_t>* frameStart = nullptr) {
+        FeatureStreamEncoder encoder;
+        std::vector<uint8_t> out(FeatureStream::headerSize);
+        encoder.encodeHeader(out.data());
+        uint8_t buffer[FeatureStream::maxFrameBytes];
+        for (int i = 0; i < frames; ++i) {
+            if (frameStart) frameStart->push_back(out.size());
+            size_t len = encoder.encode(frame(i), timestamp(i), buffer);
+            out.insert(out.end(), buffer, buffer + len);
+        }
+        return out;
+    }
+
+    static bool write(const char* path, const std::vector<uint8_t>& data) {
+        FILE* file = fopen(path, "wb");
+        if (!file) return false;
+        bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+        return fclose(file) == 0 && ok;
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Builds RIFF/WAVE files for the tests: the header fields can be set freely so
+// malformed and unusual files can be written as easily as plain 16-bit PCM.
+struct TestWav {
+    uint16_t format = 1;            // 1 PCM, 3 float, 0xFFFE extensible
+    uint16_t subFormat = 1;         // Extensible only
+    uint16_t channels = 1;
+    uint32_t rate = 44100;
+    uint16_t bitsPerSample = 16;
+    bool junkChunkFirst = false;    // An odd-sized chunk before "fmt "
+    bool writeFormat = true;
+    bool writeData = true;
+    std::vector<float> samples;     // Interleaved, in [-1, 1]
+
+    std::vector<uint8_t> encode() const {
+        std::vector<uint8_t> data;
+        for (float s : samples) appendSample(data, s);
+
+        std::vector<uint8_t> out;
+        append(out, "RIFF", 4);
+        appendU32(out, 0);          // Patched below
+        append(out, "WAVE", 4);
+        if (junkChunkFirst) {
+            append(out, "LIST", 4);
+            appendU32(out, 3);
+            append(out, "abc\0", 4);   // Three bytes plus the pad byte
+        }
+        if (writeFormat) {
+            bool extensible = format == 0xFFFE;
+            append(out, "fmt ", 4);
+            appendU32(out, extensible ? 40 : 16);
+            appendU16(out, format);
+            appendU16(out, channels);
+            appendU32(out, rate);
+            appendU32(out, rate * channels * (bitsPerSample / 8));
+            appendU16(out, channels * (bitsPerSample / 8));
+            appendU16(out, bitsPerSample);
+            if (extensible) {
+                appendU16(out, 22);
+                appendU16(out, bitsPerSample);
+                appendU32(out, 0);
+                appendU16(out, subFormat);
+                for (int i = 0; i < 14; ++i) out.push_back(0);
+            }
+        }
+        if (writeData) {
+            append(out, "data", 4);
+            appendU32(out, (uint32_t)data.size());
+            out.insert(out.end(), data.begin(), data.end());
+        }
+        uint32_t riffSize = (uint32_t)out.size() - 8;
+        memcpy(&out[4], &riffSize, 4);
+        return out;
+    }
+
+    bool write(const char* path) const {
+        std::vector<uint8_t> bytes = encode();
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        return fclose(f) == 0 && ok;
+    }
+
+    // seconds of a tone pulsing on and off twice a second, a stand-in for a beat
+    void addPulsingTone(float seconds, float hz, float amplitude) {
+        int frames = (int)(seconds * rate);
+        size_t start = samples.size() / channels;
+        for (int i = 0; i < frames; ++i) {
+            double t = (double)(start + i) / rate;
+            float envelope = fmod(t, 0.5) < 0.15 ? 1.0f : 0.2f;
+            float v = amplitude * envelope * (float)sin(2.0 * M_PI * hz * t);
+            for (int c = 0; c < channels; ++c) samples.push_back(v);
+        }
+    }
+
+    void addSilence(float seconds) {
+        samples.insert(samples.end(), (size_t)(seconds * rate) * channels, 0.0f);
+    }
+
+private:
+    static void append(std::vector<uint8_t>& out, const char* bytes, size_t n) {
+        out.insert(out.end(), bytes, bytes + n);
+    }
+    static void appendU16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(v & 0xFF);
+        out.push_back(v >> 8);
+    }
+    static void appendU32(std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back((v >> (8 * i)) & 0xFF);
+    }
+
+    void appendSample(std::vector<uint8_t>& out, float s) const {
+        bool isFloat = format == 3 || (format == 0xFFFE && subFormat == 3);
+        if (isFloat) {
+            uint32_t raw;
+            memcpy(&raw, &s, 4);
+            appendU32(out, raw);
+            return;
+        }
+        switch (bitsPerSample) {
+            case 8: out.push_back((uint8_t)lrintf(s * 127.0f + 128.0f)); break;
+            case 16: appendU16(out, (uint16_t)(int16_t)lrintf(s * 32767.0f)); break;
+            case 24: {
+                int32_t v = (int32_t)lrintf(s * 8388607.0f);
+                for (int i = 0; i < 3; ++i) out.push_back((v >> (8 * i)) & 0xFF);
+                break;
+            }
+            case 32: appendU32(out, (uint32_t)(int32_t)lrint(s * 2147483647.0)); break;
+            default: out.push_back(0); break;   // Unsupported widths only need bytes
+        }
+    }
+};
@@ -0,0 +1,236 @@
+// FeatureStream: the varint/zigzag delta encoding used for recordings, and how
+// the decoder and FeatureReplaySource cope with truncated or damaged input.
+
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../../src/sim/FeatureReplaySource.h"
+#include "../support/TestFeatures.h"
+
+static const char* const streamPath = "test_feature_stream.ggaf";
+
+void setUp(void) {}
+void tearDown(void) { remove(streamPath); }
+
+// Decodes every frame after the header; returns how many decoded
+static int decodeAll(const std::vector<uint8_t>& data, std::vector<AudioFeatures>& frames,
+                     std::vector<uint32_t>& timestamps) {
+    FeatureStreamDecoder decoder;
+    size_t pos = FeatureStream::headerSize;
+    AudioFeatures f;
+    uint32_t ts;
+    while (pos < data.size()) {
+        size_t used = decoder.decode(data.data() + pos, data.size() - pos, f, ts);
+        if (used == 0) break;
+        pos += used;
+        frames.push_back(f);
+        timestamps.push_back(ts);
+    }
+    return (int)frames.size();
+}
+
+static void assertQuantisedEqual(const AudioFeatures& a, const AudioFeatures& b) {
+    int32_t sa[FeatureStream::scalarCount], sb[FeatureStream::scalarCount];
+    uint8_t ba[FeatureStream::bandCount], bb[FeatureStream::bandCount];
+    FeatureStream::quantise(a, sa, ba);
+    FeatureStream::quantise(b, sb, bb);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(sa, sb, FeatureStream::scalarCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ba, bb, FeatureStream::bandCount);
+    TEST_ASSERT_EQUAL(a.beatDetected, b.beatDetected);
+    TEST_ASSERT_EQUAL(a.signalPresence, b.signalPresence);
+}
+
+void test_varint_and_zigzag_round_trip() {
+    const uint32_t values[] = {0, 1, 127, 128, 300, 16383, 16384, 0x0FFFFFFF, 0xFFFFFFFF};
+    for (uint32_t v : values) {
+        uint8_t buffer[5];
+        uint8_t* end = FeatureStream::putVarint(buffer, v);
+        uint32_t back;
+        TEST_ASSERT_TRUE(FeatureStream::getVarint(buffer, end, back) == end);
+        TEST_ASSERT_EQUAL_UINT32(v, back);
+        // Every shorter prefix is incomplete
+        for (uint8_t* cut = buffer; cut < end; ++cut) {
+            TEST_ASSERT_NULL(FeatureStream::getVarint(buffer, cut, back));
+        }
+    }
+    const int32_t signedValues[] = {0, -1, 1, -64, 64, INT32_MAX, INT32_MIN};
+    for (int32_t v : signedValues) {
+        TEST_ASSERT_EQUAL_INT32(v, FeatureStream::unzigzag(FeatureStream::zigzag(v)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, FeatureStream::zigzag(-1));
+    TEST_ASSERT_EQUAL_UINT32(2, FeatureStream::zigzag(1));
+}
+
+void test_stream_round_trip_across_keyframes() {
+    const int count = FeatureStream::keyframeInterval * 2 + 50;
+    std::vector<size_t> starts;
+    std::vector<uint8_t> data = TestFeatures::encode(count, &starts);
+    TEST_ASSERT_TRUE(FeatureStreamDecoder::validHeader(data.data(), data.size()));
+
+    for (int i = 0; i < count; ++i) {
+        bool keyframe = data[starts[i]] & FeatureStream::FLAG_KEYFRAME;
+        TEST_ASSERT_EQUAL(i % FeatureStream::keyframeInterval == 0, keyframe);
+    }
+
+    std::vector<AudioFeatures> frames;
+    std::vector<uint32_t> timestamps;
+    TEST_ASSERT_EQUAL_INT(count, decodeAll(data, frames, timestamps));
+    for (int i = 0; i < count; ++i) {
+        AudioFeatures original = TestFeatures::frame(i);
+        TEST_ASSERT_EQUAL_UINT32(TestFeatures::timestamp(i), timestamps[i]);
+        assertQuantisedEqual(original, frames[i]);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, original.volume, frames[i].volume);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, original.bpm, frames[i].bpm);
+        TEST_ASSERT_EQUAL_INT(original.dominantBand, frames[i].dominantBand);
+        TEST_ASSERT_EQUAL_INT(original.bassHits, frames[i].bassHits);
+    }
+
+    // Decoded frames quantise back to the same values, so re-encoding them
+    // gives the same bytes
+    FeatureStreamEncoder encoder;
+    std::vector<uint8_t> again(FeatureStream::headerSize);
+    encoder.encodeHeader(again.data());
+    uint8_t buffer[FeatureStream::maxFrameBytes];
+    for (int i = 0; i < count; ++i) {
+        size_t len = encoder.encode(frames[i], timestamps[i], buffer);
+        TEST_ASSERT_TRUE(len <= (size_t)FeatureStream::maxFrameBytes);
+        again.insert(again.end(), buffer, buffer + len);
+    }
+    TEST_ASSERT_TRUE(again == data);
+}
+
+void test_truncated_frame_is_incomplete() {
+    std::vector<size_t> starts;
+    std::vector<uint8_t> data = TestFeatures::encode(3, &starts);
+    FeatureStreamDecoder decoder;
+    AudioFeatures f;
+    uint32_t ts;
+    size_t frameLen = starts[1] - starts[0];
+    for (size_t len = 0; len < frameLen; ++len) {
+        TEST_ASSERT_EQUAL_UINT32(0, decoder.decode(data.data() + starts[0], len, f, ts));
+    }
+    TEST_ASSERT_EQUAL_UINT32(frameLen, decoder.decode(data.data() + starts[0], frameLen, f, ts));
+}
+
+void test_replay_drops_truncated_last_frame() {
+    std::vector<size_t> starts;
+    std::vector<uint8_t> data = TestFeatures::encode(40, &starts);
+    data.resize(data.size() - 3);
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+
+    FeatureReplaySource replay;
+    TEST_ASSERT_TRUE(replay.open(streamPath));
+    AudioFeatures f;
+    uint32_t ts;
+    int frames = 0;
+    while (replay.next(f, ts)) frames++;
+    TEST_ASSERT_EQUAL_INT(39, frames);
+    TEST_ASSERT_EQUAL_UINT32(TestFeatures::timestamp(38), replay.getLastTimestamp());
+    TEST_ASSERT_FALSE(replay.next(f, ts));
+}
+
+void test_replay_rejects_bad_headers() {
+    std::vector<uint8_t> good = TestFeatures::encode(2);
+    FeatureReplaySource replay;
+
+    TEST_ASSERT_FALSE(replay.open("test_feature_stream_missing.ggaf"));
+
+    std::vector<uint8_t> data = good;
+    data[0] = 'X';
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+    TEST_ASSERT_FALSE(replay.open(streamPath));
+
+    data = good;
+    data[4] = FeatureStream::version + 1;
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+    TEST_ASSERT_FALSE(replay.open(streamPath));
+
+    data = good;
+    data[5] = FeatureStream::bandCount + 1;
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+    TEST_ASSERT_FALSE(replay.open(streamPath));
+
+    data.assign(good.begin(), good.begin() + 4);
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+    TEST_ASSERT_FALSE(replay.open(streamPath));
+
+    // A header alone is a valid, empty recording
+    data.assign(good.begin(), good.begin() + FeatureStream::headerSize);
+    TEST_ASSERT_TRUE(TestFeatures::write(streamPath, data));
+    TEST_ASSERT_TRUE(replay.open(streamPath));
+    AudioFeatures f;
+    uint32_t ts;
+    TEST_ASSERT_FALSE(replay.next(f, ts));
+}
+
+void test_overlong_varint_stops_decoding() {
+    std::vector<uint8_t> data = TestFeatures::encode(1);
+    data.resize(FeatureStream::headerSize + 1);
+    data.insert(data.end(), 8, 0x80);       // dt never terminates
+    data.push_back(0x01);
+    FeatureStreamDecoder decoder;
+    AudioFeatures f;
+    uint32_t ts;
+    TEST_ASSERT_EQUAL_UINT32(0, decoder.decode(data.data() + FeatureStream::headerSize,
+                                               data.size() - FeatureStream::headerSize, f, ts));
+}
+
+void test_damaged_delta_heals_at_next_keyframe() {
+    const int count = FeatureStream::keyframeInterval + 20;
+    std::vector<size_t> starts;
+    std::vector<uint8_t> data = TestFeatures::encode(count, &starts);
+
+    // Flip a payload bit of frame 10's first scalar; the varint keeps its length
+    // so the frames stay aligned, but the error carries through every delta
+    std::vector<uint8_t> damaged = data;
+    size_t at = starts[10] + 1;
+    while (damaged[at] & 0x80) at++;        // Skip the dt varint
+    at++;
+    damaged[at] ^= 0x02;
+
+    std::vector<AudioFeatures> frames;
+    std::vector<uint32_t> timestamps;
+    TEST_ASSERT_EQUAL_INT(count, decodeAll(damaged, frames, timestamps));
+    TEST_ASSERT_TRUE(frames[10].volume != TestFeatures::frame(10).volume);
+    TEST_ASSERT_TRUE(frames[200].volume != TestFeatures::frame(200).volume);
+    for (int i = FeatureStream::keyframeInterval; i < count; ++i) {
+        assertQuantisedEqual(TestFeatures::frame(i), frames[i]);
+        TEST_ASSERT_EQUAL_UINT32(TestFeatures::timestamp(i), timestamps[i]);
+    }
+}
+
+void test_garbage_never_reads_past_the_end() {
+    // Arbitrary bytes decode to nonsense but every frame stays within the buffer
+    std::vector<uint8_t> data = TestFeatures::encode(0);
+    uint32_t x = 0x9E3779B9u;
+    for (int i = 0; i < 4096; ++i) {
+        x = x * 1664525u + 1013904223u;
+        data.push_back((uint8_t)(x >> 24));
+    }
+    FeatureStreamDecoder decoder;
+    size_t pos = FeatureStream::headerSize;
+    AudioFeatures f;
+    uint32_t ts;
+    while (pos < data.size()) {
+        size_t used = decoder.decode(data.data() + pos, data.size() - pos, f, ts);
+        if (used == 0) break;
+        TEST_ASSERT_TRUE(used <= data.size() - pos);
+        pos += used;
+    }
+    TEST_ASSERT_TRUE(pos <= data.size());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_varint_and_zigzag_round_trip);
+    RUN_TEST(test_stream_round_trip_across_keyframes);
+    RUN_TEST(test_truncated_frame_is_incomplete);
+    RUN_TEST(test_replay_drops_truncated_last_frame);
+    RUN_TEST(test_replay_rejects_bad_headers);
+    RUN_TEST(test_overlong_varint_stops_decoding);
+    RUN_TEST(test_damaged_delta_heals_at_next_keyframe);
+    RUN_TEST(test_garbage_never_reads_past_the_end);
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+// LayerManager's output cache: a keyed layer renders once per key and is then
+// re-blended, and a miss renders the way an uncached frame would, including at
+// a reduced level of detail.
+
+#include <unity.h>
+#include <deque>
+
+#include "../../src/core/LedArena.h"
+#include "../../src/scenes/LayerManager.h"
+
+static const int ledCount = 600;    // Long enough for two LOD steps
+
+// A ramp that is drawn at full resolution by render() and at one sample per
+// step by renderSampled(); counts both
+class ProbeLayer : public VisualLayer {
+public:
+    uint32_t key = 0;
+    uint8_t lod = 0;
+    int renders = 0;
+    int sampledRenders = 0;
+
+    ProbeLayer(uint32_t key, uint8_t lod) : key(key), lod(lod) { name = "Probe"; }
+
+    void update(const AudioFeatures&, const std::deque<AudioSnapshot>&, const FrameContext&) override {}
+    void render(CRGB* leds, int count) override {
+        renders++;
+        for (int i = 0; i < count; ++i) leds[i] += color(i);
+    }
+    void renderSampled(CRGB* out, int samples, int count, int step) override {
+        sampledRenders++;
+        for (int k = 0; k < samples; ++k) out[k] += color(k * step);
+    }
+    uint32_t renderKey() const override { return key; }
+    uint8_t maxLodShift() const override { return lod; }
+
+    static CRGB color(int i) { return CRGB((i * 7) & 0xFF, (i * i) & 0xFF, 40); }
+};
+
+struct Stack {
+    CRGB leds[ledCount];
+    uint8_t scratchMemory[ledCount * LAYER_SCRATCH_BYTES_PER_LED];
+    ArenaRegion scratch;
+    LayerManager manager;
+    ProbeLayer* layer;
+
+    Stack(uint32_t key, uint8_t lod) {
+        scratch.init(scratchMemory, sizeof(scratchMemory));
+        manager.setLEDs(leds, ledCount);
+        manager.setScratch(&scratch);
+        manager.setRenderBudget(0);
+        layer = new ProbeLayer(key, lod);
+        manager.addLayer(layer, LayerType::OVERLAY);
+    }
+
+    void frame() {
+        AudioFeatures audio;
+        std::deque<AudioSnapshot> history;
+        FrameContext context;
+        fill_solid(leds, ledCount, CRGB::Black);
+        manager.updateLayers(audio, history, context);
+        manager.renderLayers();
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_keyed_layer_renders_once_per_key() {
+    static Stack cached(5, 0), plain(0, 0);
+    for (int i = 0; i < 4; ++i) {
+        cached.frame();
+        plain.frame();
+        TEST_ASSERT_EQUAL_MEMORY(plain.leds, cached.leds, sizeof(cached.leds));
+    }
+    TEST_ASSERT_EQUAL_INT(1, cached.layer->renders);
+    TEST_ASSERT_EQUAL_INT(4, plain.layer->renders);
+
+    cached.layer->key = 6;
+    cached.frame();
+    TEST_ASSERT_EQUAL_INT(2, cached.layer->renders);
+}
+
+void test_cache_miss_renders_at_the_layer_lod() {
+    static Stack cached(5, 2), plain(0, 2);
+    TEST_ASSERT_EQUAL_UINT8(2, cached.manager.getLayers()[0].lodShift);
+    for (int i = 0; i < 3; ++i) {
+        cached.frame();
+        plain.frame();
+        TEST_ASSERT_EQUAL_MEMORY(plain.leds, cached.leds, sizeof(cached.leds));
+    }
+    TEST_ASSERT_EQUAL_INT(0, cached.layer->renders);
+    TEST_ASSERT_EQUAL_INT(1, cached.layer->sampledRenders);
+    TEST_ASSERT_EQUAL_INT(3, plain.layer->sampledRenders);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_keyed_layer_renders_once_per_key);
+    RUN_TEST(test_cache_miss_renders_at_the_layer_lod);
+    return UNITY_END();
+}
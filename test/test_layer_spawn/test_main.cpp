@@ -0,0 +1,84 @@
+// Spawning and expiring pooled layers must not touch the heap: the pool
+// preallocates each class, the stack vector is reserved and layer names are
+// literals. Counts every operator new while layers come and go.
+
+#include <unity.h>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "../../src/core/LedArena.h"
+#include "../../src/scenes/LayerManager.h"
+
+static bool countAllocations = false;
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    if (countAllocations) allocationCount++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+// Kept out of line so GCC doesn't see free() paired with a new-expression
+__attribute__((noinline)) static void countedFree(void* p) noexcept { free(p); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+static const int ledCount = 120;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_spawn_and_expire_without_allocating() {
+    static CRGB leds[ledCount];
+    static uint8_t scratchMemory[ledCount * LAYER_SCRATCH_BYTES_PER_LED];
+    ArenaRegion scratch;
+    scratch.init(scratchMemory, sizeof(scratchMemory));
+
+    LayerPool pool;
+    pool.registerCatalog();
+    LayerManager manager;
+    manager.setLEDs(leds, ledCount);
+    manager.setScratch(&scratch);
+    manager.setLayerPool(&pool);
+
+    AudioFeatures audio;
+    audio.volume = 0.3f;
+    audio.energy = 500.0f;
+    audio.signalPresence = true;
+    std::deque<AudioSnapshot> history;
+    FrameContext frame;
+
+    const LayerType types[] = {LayerType::REACTIVE, LayerType::HIGHLIGHT, LayerType::OVERLAY,
+                               LayerType::ENERGY, LayerType::MOOD_ARC};
+    int spawned = 0;
+    uint64_t nowUs = 0;
+    for (int round = 0; round < 2; ++round) {
+        // The first round brings every class's slab and cache stats in; the
+        // second has to manage without the heap
+        countAllocations = round == 1;
+        for (int i = 0; i < 400; ++i) {
+            nowUs += 100000;
+            native::setMicros(nowUs);
+            frame.nowMs = millis();
+            if (manager.addLayerByType(types[i % 5], 300 + (i % 7) * 100)) spawned++;
+            manager.updateLayers(audio, history, frame);
+            manager.renderLayers();
+        }
+    }
+    countAllocations = false;
+
+    TEST_ASSERT_TRUE(spawned > 200);
+    TEST_ASSERT_TRUE(manager.activeCount() <= LAYER_STACK_RESERVE);
+    TEST_ASSERT_EQUAL_UINT32(0, allocationCount);
+    manager.clearLayers();
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spawn_and_expire_without_allocating);
+    return UNITY_END();
+}
@@ -0,0 +1,40 @@
+// End-to-end replay: a synthetic feature recording played back through the
+// whole native pipeline with a fixed seed. Replay skips audio analysis, so this
+// pins the decoder and the visuals independently of the FFT. As with test_sim,
+// update the expected values when a change is meant to alter the output.
+
+#include <unity.h>
+#include <cstdio>
+
+#include "../../src/sim/Simulation.h"
+#include "../support/TestFeatures.h"
+
+static const char* const replayPath = "test_replay.ggaf";
+
+static const int recordedFrames = FeatureStream::keyframeInterval + 100;
+static const long expectedFrames = 356;
+static const uint32_t expectedChecksum = 0x5f7e8570;
+
+void setUp(void) {}
+void tearDown(void) { remove(replayPath); }
+
+void test_seeded_replay_matches_golden_checksum() {
+    TEST_ASSERT_TRUE(TestFeatures::write(replayPath, TestFeatures::encode(recordedFrames)));
+
+    SimOptions opts;
+    opts.replayPath = replayPath;
+    opts.seed = 7;
+    opts.allLayers = true;
+    opts.quiet = true;
+    opts.layerBudgetUs = 0;     // The governor acts on host time; keep it out
+    SimResult result;
+    TEST_ASSERT_EQUAL_INT(0, runSimulation(opts, result));
+    TEST_ASSERT_EQUAL_INT32(expectedFrames, result.frames);
+    TEST_ASSERT_EQUAL_HEX32(expectedChecksum, result.checksum);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_seeded_replay_matches_golden_checksum);
+    return UNITY_END();
+}
@@ -0,0 +1,41 @@
+// End-to-end: a short synthetic WAV through the whole native pipeline with a
+// fixed seed. The checksum covers every LED frame, so any change in what the
+// strips show fails here. When a change is meant to alter the output, update
+// the expected value from the sim's summary line and say so in the commit.
+
+#include <unity.h>
+#include <cstdio>
+
+#include "../../src/sim/Simulation.h"
+#include "../support/TestWav.h"
+
+static const char* const wavPath = "test_sim.wav";
+
+static const long expectedFrames = 345;
+static const uint32_t expectedChecksum = 0x1470996c;
+
+void setUp(void) {}
+void tearDown(void) { remove(wavPath); }
+
+void test_seeded_wav_run_matches_golden_checksum() {
+    TestWav wav;
+    wav.addPulsingTone(4.0f, 110.0f, 0.6f);
+    TEST_ASSERT_TRUE(wav.write(wavPath));
+
+    SimOptions opts;
+    opts.wavPath = wavPath;
+    opts.seed = 7;
+    opts.allLayers = true;
+    opts.quiet = true;
+    opts.layerBudgetUs = 0;     // The governor acts on host time; keep it out
+    SimResult result;
+    TEST_ASSERT_EQUAL_INT(0, runSimulation(opts, result));
+    TEST_ASSERT_EQUAL_INT32(expectedFrames, result.frames);
+    TEST_ASSERT_EQUAL_HEX32(expectedChecksum, result.checksum);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_seeded_wav_run_matches_golden_checksum);
+    return UNITY_END();
+}
@@ -0,0 +1,38 @@
+// Regression: a burst of sound followed by long silence, every layer attached.
+// As the audio fades, spark probabilities shrink towards zero; the sparse
+// sampler once turned those into a negative index and the run segfaulted.
+
+#include <unity.h>
+#include <cstdio>
+
+#include "../../src/sim/Simulation.h"
+#include "../support/TestWav.h"
+
+static const char* const wavPath = "test_sim_silence.wav";
+
+void setUp(void) {}
+void tearDown(void) { remove(wavPath); }
+
+void test_all_layers_survive_silence() {
+    TestWav wav;
+    wav.addPulsingTone(2.0f, 110.0f, 0.6f);
+    wav.addSilence(10.0f);
+    TEST_ASSERT_TRUE(wav.write(wavPath));
+
+    SimOptions opts;
+    opts.wavPath = wavPath;
+    opts.seed = 7;
+    opts.allLayers = true;
+    opts.quiet = true;
+    opts.layerBudgetUs = 0;
+    SimResult result;
+    TEST_ASSERT_EQUAL_INT(0, runSimulation(opts, result));
+    TEST_ASSERT_TRUE(result.frames > 1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.1, 12.0, result.audioSeconds);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_layers_survive_silence);
+    return UNITY_END();
+}
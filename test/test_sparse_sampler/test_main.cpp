@@ -0,0 +1,99 @@
+// SparseSampler: the geometric-gap walk has to stay inside the range for any
+// probability, including ones too small for 1 - p to differ from 1 in float.
+
+#include <unity.h>
+#include <cmath>
+#include <vector>
+
+#include "../../src/utils/SparseSampler.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Runs forEach and checks every index is in range and strictly increasing
+static int visit(SparseSampler& sampler, int count, float p, std::vector<int>* seen = nullptr) {
+    int last = -1;
+    int calls = 0;
+    int hits = sampler.forEach(count, p, [&](int i) {
+        TEST_ASSERT_TRUE(i >= 0 && i < count);
+        TEST_ASSERT_TRUE(i > last);
+        last = i;
+        calls++;
+        if (seen) seen->push_back(i);
+    });
+    TEST_ASSERT_EQUAL_INT(calls, hits);
+    return hits;
+}
+
+void test_zero_and_negative_probability_visit_nothing() {
+    SparseSampler sampler;
+    sampler.seed(1, "test");
+    TEST_ASSERT_EQUAL_INT(0, visit(sampler, 1000, 0.0f));
+    TEST_ASSERT_EQUAL_INT(0, visit(sampler, 1000, -0.5f));
+    TEST_ASSERT_EQUAL_INT(0, visit(sampler, 1000, NAN));
+}
+
+void test_probability_one_or_more_visits_everything() {
+    SparseSampler sampler;
+    sampler.seed(1, "test");
+    std::vector<int> seen;
+    TEST_ASSERT_EQUAL_INT(300, visit(sampler, 300, 1.0f, &seen));
+    for (int i = 0; i < 300; ++i) TEST_ASSERT_EQUAL_INT(i, seen[i]);
+    TEST_ASSERT_EQUAL_INT(300, visit(sampler, 300, 7.0f));
+}
+
+void test_tiny_probabilities_stay_in_range() {
+    // 1 - p == 1 in float for all of these; the old code indexed leds[INT_MIN]
+    const float tiny[] = {5e-8f, 1e-9f, 1e-20f, 1e-38f, 1e-45f};
+    SparseSampler sampler;
+    sampler.seed(3, "tiny");
+    for (float p : tiny) {
+        int hits = 0;
+        for (int round = 0; round < 2000; ++round) hits += visit(sampler, 3000, p);
+        TEST_ASSERT_TRUE(hits <= 1);
+    }
+}
+
+void test_empty_range_visits_nothing() {
+    SparseSampler sampler;
+    sampler.seed(1, "test");
+    TEST_ASSERT_EQUAL_INT(0, visit(sampler, 0, 0.5f));
+    TEST_ASSERT_EQUAL_INT(0, visit(sampler, -4, 1.0f));
+}
+
+void test_hit_rate_matches_probability() {
+    const float rates[] = {0.01f, 0.1f, 0.5f, 0.9f};
+    SparseSampler sampler;
+    sampler.seed(11, "rate");
+    for (float p : rates) {
+        long hits = 0;
+        const int rounds = 200, count = 1000;
+        for (int round = 0; round < rounds; ++round) hits += visit(sampler, count, p);
+        float observed = (float)hits / (rounds * count);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f * p + 0.002f, p, observed);
+    }
+}
+
+void test_same_seed_and_label_repeat() {
+    SparseSampler a, b, c;
+    a.seed(42, "sparks");
+    b.seed(42, "sparks");
+    c.seed(42, "shimmer");
+    std::vector<int> sa, sb, sc;
+    visit(a, 2000, 0.05f, &sa);
+    visit(b, 2000, 0.05f, &sb);
+    visit(c, 2000, 0.05f, &sc);
+    TEST_ASSERT_TRUE(sa == sb);
+    TEST_ASSERT_FALSE(sa == sc);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_zero_and_negative_probability_visit_nothing);
+    RUN_TEST(test_probability_one_or_more_visits_everything);
+    RUN_TEST(test_tiny_probabilities_stay_in_range);
+    RUN_TEST(test_empty_range_visits_nothing);
+    RUN_TEST(test_hit_rate_matches_probability);
+    RUN_TEST(test_same_seed_and_label_repeat);
+    return UNITY_END();
+}
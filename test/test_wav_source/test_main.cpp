@@ -0,0 +1,152 @@
+// WavAudioSource header parsing and sample decoding (src/sim/WavAudioSource.h)
+
+#include <unity.h>
+#include <cstdio>
+#include <vector>
+
+#include "../../src/sim/WavAudioSource.h"
+#include "../support/TestWav.h"
+
+static const char* const wavPath = "test_wav_source.wav";
+
+void setUp(void) {}
+void tearDown(void) { remove(wavPath); }
+
+// The first `count` samples of the file as AudioProcessor would get them
+static std::vector<float> readBack(const TestWav& wav, WavAudioSource& source, int count) {
+    TEST_ASSERT_TRUE(wav.write(wavPath));
+    TEST_ASSERT_TRUE(source.open(wavPath));
+    std::vector<float> out(count);
+    TEST_ASSERT_TRUE(source.read(out.data(), count));
+    return out;
+}
+
+static TestWav ramp(uint16_t bits, uint16_t format = 1) {
+    TestWav wav;
+    wav.rate = SAMPLE_RATE;
+    wav.bitsPerSample = bits;
+    wav.format = format;
+    for (int i = 0; i < 64; ++i) wav.samples.push_back((i - 32) / 40.0f);
+    return wav;
+}
+
+// The source interpolates towards the next sample, so the file's last one isn't
+// reached before the zero padding; the checks stop short of it
+static void assertRamp(const std::vector<float>& samples, float tolerance) {
+    for (int i = 0; i < 48; ++i) TEST_ASSERT_FLOAT_WITHIN(tolerance, (i - 32) / 40.0f, samples[i]);
+}
+
+void test_pcm16_mono() {
+    WavAudioSource source;
+    TestWav wav = ramp(16);
+    assertRamp(readBack(wav, source, 64), 1e-4f);
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_RATE, source.getSourceRate());
+    TEST_ASSERT_EQUAL_UINT16(1, source.getChannels());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 64.0f / SAMPLE_RATE, source.getDurationSeconds());
+}
+
+void test_pcm8_24_32_and_float() {
+    WavAudioSource a, b, c, d;
+    assertRamp(readBack(ramp(8), a, 64), 1.0f / 100);
+    assertRamp(readBack(ramp(24), b, 64), 1e-5f);
+    assertRamp(readBack(ramp(32), c, 64), 1e-6f);
+    assertRamp(readBack(ramp(32, 3), d, 64), 0.0f);
+}
+
+void test_extensible_format_uses_subformat() {
+    WavAudioSource source;
+    TestWav wav = ramp(32, 0xFFFE);
+    wav.subFormat = 3;
+    assertRamp(readBack(wav, source, 64), 0.0f);
+}
+
+void test_stereo_is_downmixed() {
+    TestWav wav;
+    wav.rate = SAMPLE_RATE;
+    wav.channels = 2;
+    for (int i = 0; i < 16; ++i) {
+        wav.samples.push_back(0.5f);
+        wav.samples.push_back(-0.25f);
+    }
+    WavAudioSource source;
+    std::vector<float> out = readBack(wav, source, 16);
+    TEST_ASSERT_EQUAL_UINT16(2, source.getChannels());
+    for (int i = 0; i < 12; ++i) TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.125f, out[i]);
+}
+
+void test_unknown_chunk_before_format_is_skipped() {
+    WavAudioSource source;
+    TestWav wav = ramp(16);
+    wav.junkChunkFirst = true;
+    assertRamp(readBack(wav, source, 64), 1e-4f);
+}
+
+void test_other_rates_are_resampled() {
+    TestWav wav;
+    wav.rate = SAMPLE_RATE / 2;
+    for (int i = 0; i < 32; ++i) wav.samples.push_back(i / 64.0f);
+    WavAudioSource source;
+    std::vector<float> out = readBack(wav, source, 60);
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_RATE / 2, source.getSourceRate());
+    // Every other output sample falls halfway between two source samples
+    for (int i = 0; i < 60; ++i) TEST_ASSERT_FLOAT_WITHIN(1e-4f, i / 128.0f, out[i]);
+}
+
+void test_short_last_block_is_zero_padded_then_ends() {
+    WavAudioSource source;
+    TestWav wav = ramp(16);
+    TEST_ASSERT_TRUE(wav.write(wavPath));
+    TEST_ASSERT_TRUE(source.open(wavPath));
+    std::vector<float> out(100, 1.0f);
+    TEST_ASSERT_TRUE(source.read(out.data(), 100));
+    for (int i = 64; i < 100; ++i) TEST_ASSERT_EQUAL_INT(0, (int)(out[i] * 1000));
+    TEST_ASSERT_FALSE(source.read(out.data(), 100));
+}
+
+void test_rejects_malformed_and_unsupported_files() {
+    WavAudioSource source;
+    TEST_ASSERT_FALSE(source.open("does_not_exist.wav"));
+
+    TestWav noFormat = ramp(16);
+    noFormat.writeFormat = false;
+    TEST_ASSERT_TRUE(noFormat.write(wavPath));
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    TestWav noData = ramp(16);
+    noData.writeData = false;
+    TEST_ASSERT_TRUE(noData.write(wavPath));
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    TestWav adpcm = ramp(16, 2);
+    TEST_ASSERT_TRUE(adpcm.write(wavPath));
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    TestWav floatWrongWidth = ramp(16, 3);
+    TEST_ASSERT_TRUE(floatWrongWidth.write(wavPath));
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    TestWav oddWidth = ramp(12);
+    TEST_ASSERT_TRUE(oddWidth.write(wavPath));
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    FILE* f = fopen(wavPath, "wb");
+    fputs("RIFX\0\0\0\0WAVEfmt ", f);
+    fclose(f);
+    TEST_ASSERT_FALSE(source.open(wavPath));
+
+    std::vector<float> out(8);
+    TEST_ASSERT_FALSE(source.read(out.data(), 8));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pcm16_mono);
+    RUN_TEST(test_pcm8_24_32_and_float);
+    RUN_TEST(test_extensible_format_uses_subformat);
+    RUN_TEST(test_stereo_is_downmixed);
+    RUN_TEST(test_unknown_chunk_before_format_is_skipped);
+    RUN_TEST(test_other_rates_are_resampled);
+    RUN_TEST(test_short_last_block_is_zero_padded_then_ends);
+    RUN_TEST(test_rejects_malformed_and_unsupported_files);
+    return UNITY_END();
+}